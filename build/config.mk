@@ -18,6 +18,14 @@ SANITIZERS ?= address,undefined
 # Set whether to enable static analysis
 STATIC_ANALYSIS ?= ENABLED
 
+# Options passed to test runners
+# e.g. `--jobs 4 --timeout 10000`
+TEST_FLAGS ?=
+
+# Options passed to benchmark runners
+# e.g. `--output results.tsv` or `--baseline results.tsv --threshold 5`
+BENCH_FLAGS ?=
+
 # The clang command line to use
 CLANG ?= clang
 
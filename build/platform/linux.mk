@@ -2,5 +2,8 @@ PLATFORM_SOURCEDIRS += linux
 
 include $(PLATFORM_DIR)/unix.mk
 
+# Older glibc keeps pthreads out of libc proper.
+GLOBAL_LFLAGS += -pthread
+
 BEGIN_FULL_STATIC = -Wl,--whole-archive $(eval)
 END_FULL_STATIC = $(eval) -Wl,--no-whole-archive
@@ -17,6 +17,9 @@ genbackends: $(GEN_BACKENDS_LIB)
 .PHONY: test_genbackends
 test_genbackends:
 
+.PHONY: bench_genbackends
+bench_genbackends:
+
 .PHONY: clean_genbackends
 clean_genbackends:
 	-$(RM) $(GEN_BACKENDS_OBJECTS)
@@ -0,0 +1,13 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+
+#include <genbackends.h>
+
+GEN_BACKENDS_DEFER(async_io_queue_create, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(async_io_queue_destroy, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(
+        async_io_register_buffers, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(async_io_submit, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(async_io_reap, gen_error_t*, darwin, "libc", return)
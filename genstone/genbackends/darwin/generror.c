@@ -6,3 +6,4 @@
 #include <genbackends.h>
 
 GEN_BACKENDS_DEFER(abort, void, darwin, "libc", )
+GEN_BACKENDS_DEFER(error_watch_thread, void, darwin, "libc", )
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+
+#include <genbackends.h>
+
+GEN_BACKENDS_DEFER(event_loop_create, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(event_loop_destroy, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(event_loop_add, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(event_loop_modify, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(event_loop_remove, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(event_loop_wake, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(event_loop_wait, gen_error_t*, darwin, "libc", return)
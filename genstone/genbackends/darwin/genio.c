@@ -7,3 +7,14 @@
 
 GEN_BACKENDS_DEFER(terminal_write, gen_error_t*, darwin, "libc", return)
 
+GEN_BACKENDS_DEFER(file_open, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_close, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_get_standard, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_read, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_write, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_advise, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_get_size, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_map, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_unmap, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_mapping_advise, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(file_mapping_sync, gen_error_t*, darwin, "libc", return)
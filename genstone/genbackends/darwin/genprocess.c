@@ -0,0 +1,10 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+
+#include <genbackends.h>
+
+GEN_BACKENDS_DEFER(process_fork, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(process_kill, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(process_wait, gen_error_t*, darwin, "libc", return)
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+
+#include <genbackends.h>
+
+GEN_BACKENDS_DEFER(thread_create, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(thread_join, gen_error_t*, darwin, "libc", return)
+GEN_BACKENDS_DEFER(
+        thread_get_processor_count, gen_error_t*, darwin, "libc", return)
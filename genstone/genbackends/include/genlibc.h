@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_LIBC_H
+#define GEN_LIBC_H
+
+#include <gencommon.h>
+
+// Utilities from the libc backend which are also used by the backends layered
+// over it.
+
+gen_error_type_t gen_libc_internal_errno_error_type(const int error);
+
+#endif
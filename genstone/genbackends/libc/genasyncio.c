@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genasyncio.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ISO C has no asynchronous IO so requests are performed synchronously at
+// submission and their completions are queued up to be reaped.
+typedef struct {
+    gen_async_io_completion_t* completions;
+    gen_size_t head;
+    gen_size_t count;
+} gen_libc_async_io_queue_t;
+
+GEN_USED gen_error_t* gen_libc_async_io_queue_create(
+        const gen_size_t depth,
+        gen_async_io_queue_t* const restrict out_queue) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_libc_async_io_queue_t* const native = calloc(1, sizeof(*native));
+    if(!native) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate async IO queue");
+    }
+
+    native->completions = calloc(depth, sizeof(gen_async_io_completion_t));
+    if(!native->completions) {
+        free(native);
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate completion queue");
+    }
+
+    out_queue->native = native;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_async_io_queue_destroy(
+        gen_async_io_queue_t* const restrict queue) {
+
+    gen_libc_async_io_queue_t* const native = queue->native;
+
+    free(native->completions);
+    free(native);
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_async_io_register_buffers(
+        GEN_UNUSED gen_async_io_queue_t* const restrict queue,
+        GEN_UNUSED const gen_async_io_buffer_t* const restrict buffers,
+        GEN_UNUSED const gen_size_t count) {
+
+    // Requests are serviced through stdio so there is nothing to pin.
+    return GEN_NULL;
+}
+
+static gen_bool_t gen_libc_async_io_internal_perform(
+        const gen_async_io_request_t* const restrict request,
+        gen_size_t* const restrict out_transferred) {
+
+    FILE* const file = (FILE*) request->file->native;
+
+    *out_transferred = 0;
+
+    if(request->operation == GEN_ASYNC_IO_OPERATION_SYNC) {
+        return !fflush(file);
+    }
+
+    if(request->offset > LONG_MAX) {
+        errno = EOVERFLOW;
+        return gen_false;
+    }
+
+    if(fseek(file, (long) request->offset, SEEK_SET)) return gen_false;
+
+    if(request->operation == GEN_ASYNC_IO_OPERATION_READ) {
+        *out_transferred = fread(request->buffer, 1, request->size, file);
+        if(ferror(file)) {
+            clearerr(file);
+            return gen_false;
+        }
+    }
+    else {
+        *out_transferred = fwrite(request->buffer, 1, request->size, file);
+        if(*out_transferred != request->size) return gen_false;
+    }
+
+    return gen_true;
+}
+
+GEN_USED gen_error_t* gen_libc_async_io_submit(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_request_t* const restrict requests,
+        const gen_size_t count, gen_size_t* const restrict out_submitted) {
+
+    gen_libc_async_io_queue_t* const native = queue->native;
+
+    for(gen_size_t i = 0; i < count; ++i) {
+        gen_async_io_completion_t* const completion =
+                &native->completions[
+                    (native->head + native->count) % queue->depth];
+        ++native->count;
+
+        *completion = (gen_async_io_completion_t) {0};
+        completion->user_data = requests[i].user_data;
+
+        errno = 0;
+        if(!gen_libc_async_io_internal_perform(
+                &requests[i], &completion->transferred)) {
+
+            completion->failed = gen_true;
+            completion->error = gen_libc_internal_errno_error_type(errno);
+        }
+    }
+
+    *out_submitted = count;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_async_io_reap(
+        gen_async_io_queue_t* const restrict queue,
+        gen_async_io_completion_t* const restrict out_completions,
+        const gen_size_t limit, GEN_UNUSED const gen_size_t minimum,
+        gen_size_t* const restrict out_count) {
+
+    // Everything in flight has already completed, so `minimum` is always met.
+    gen_libc_async_io_queue_t* const native = queue->native;
+
+    gen_size_t count = 0;
+    for(; count < limit && native->count; ++count) {
+        out_completions[count] = native->completions[native->head];
+        native->head = (native->head + 1) % queue->depth;
+        --native->count;
+    }
+    *out_count = count;
+
+    return GEN_NULL;
+}
@@ -4,5 +4,107 @@
 #include <gencommon.h>
 
 #include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
 
 GEN_BACKENDS_DEFER_NOGEN(abort, GEN_NORETURN void, libc, "abort", )
+
+// ISO C has no hook for thread exit, and this backend cannot start threads, so
+// only the main thread ever has a context to release.
+GEN_USED void gen_libc_error_watch_thread(void) {}
+
+// ISO C only guarantees a handful of `errno` values so everything past those
+// is conditional on the platform providing it.
+gen_error_type_t gen_libc_internal_errno_error_type(const int error) {
+    switch(error) {
+        case EDOM: return GEN_ERROR_OUT_OF_BOUNDS;
+        case ERANGE: return GEN_ERROR_OUT_OF_BOUNDS;
+        case EILSEQ: return GEN_ERROR_BAD_CONTENT;
+#ifdef EPERM
+        case EPERM: return GEN_ERROR_PERMISSION;
+#endif
+#ifdef EACCES
+        case EACCES: return GEN_ERROR_PERMISSION;
+#endif
+#ifdef EROFS
+        case EROFS: return GEN_ERROR_PERMISSION;
+#endif
+#ifdef ENOENT
+        case ENOENT: return GEN_ERROR_NO_SUCH_OBJECT;
+#endif
+#ifdef ENXIO
+        case ENXIO: return GEN_ERROR_NO_SUCH_OBJECT;
+#endif
+#ifdef EBADF
+        case EBADF: return GEN_ERROR_INVALID_PARAMETER;
+#endif
+#ifdef EINVAL
+        case EINVAL: return GEN_ERROR_INVALID_PARAMETER;
+#endif
+#ifdef EFAULT
+        case EFAULT: return GEN_ERROR_INVALID_PARAMETER;
+#endif
+#ifdef EIO
+        case EIO: return GEN_ERROR_IO;
+#endif
+#ifdef ENOMEM
+        case ENOMEM: return GEN_ERROR_OUT_OF_MEMORY;
+#endif
+#ifdef ENOSPC
+        case ENOSPC: return GEN_ERROR_OUT_OF_SPACE;
+#endif
+#ifdef EFBIG
+        case EFBIG: return GEN_ERROR_TOO_LONG;
+#endif
+#ifdef ENAMETOOLONG
+        case ENAMETOOLONG: return GEN_ERROR_TOO_LONG;
+#endif
+#ifdef EEXIST
+        case EEXIST: return GEN_ERROR_ALREADY_EXISTS;
+#endif
+#ifdef EISDIR
+        case EISDIR: return GEN_ERROR_WRONG_OBJECT_TYPE;
+#endif
+#ifdef ENOTDIR
+        case ENOTDIR: return GEN_ERROR_WRONG_OBJECT_TYPE;
+#endif
+#ifdef ENODEV
+        case ENODEV: return GEN_ERROR_WRONG_OBJECT_TYPE;
+#endif
+#ifdef EMFILE
+        case EMFILE: return GEN_ERROR_OUT_OF_HANDLES;
+#endif
+#ifdef ENFILE
+        case ENFILE: return GEN_ERROR_OUT_OF_HANDLES;
+#endif
+#ifdef EBUSY
+        case EBUSY: return GEN_ERROR_IN_USE;
+#endif
+#ifdef ETXTBSY
+        case ETXTBSY: return GEN_ERROR_IN_USE;
+#endif
+#ifdef ENOSYS
+        case ENOSYS: return GEN_ERROR_NOT_IMPLEMENTED;
+#endif
+#ifdef EOPNOTSUPP
+        case EOPNOTSUPP: return GEN_ERROR_NOT_IMPLEMENTED;
+#endif
+#ifdef ETIMEDOUT
+        case ETIMEDOUT: return GEN_ERROR_TIMEOUT;
+#endif
+#ifdef EAGAIN
+        case EAGAIN: return GEN_ERROR_BAD_TIMING;
+#endif
+#ifdef EINTR
+        case EINTR: return GEN_ERROR_BAD_TIMING;
+#endif
+#ifdef ESPIPE
+        case ESPIPE: return GEN_ERROR_BAD_OPERATION;
+#endif
+#ifdef EPIPE
+        case EPIPE: return GEN_ERROR_BAD_OPERATION;
+#endif
+        default: return GEN_ERROR_UNKNOWN;
+    }
+}
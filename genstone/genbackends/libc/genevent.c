@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genevent.h>
+
+#include <genbackends.h>
+
+// ISO C has no facility for waiting on readiness.
+#define GEN_LIBC_EVENT_NOT_IMPLEMENTED(func, ...) \
+    GEN_USED gen_error_t* gen_libc_##func(__VA_ARGS__) { \
+        gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME); \
+        GEN_TOOLING_AUTO gen_error_t* error; \
+        return gen_error_attach_backtrace( \
+                GEN_ERROR_NOT_IMPLEMENTED, GEN_LINE_STRING, \
+                "Event loops are not supported on this platform"); \
+    }
+
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_create, GEN_UNUSED gen_event_loop_t* const restrict loop)
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_destroy, GEN_UNUSED gen_event_loop_t* const restrict loop)
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_add, GEN_UNUSED gen_event_loop_t* const restrict loop,
+        GEN_UNUSED gen_event_source_t* const restrict source)
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_modify, GEN_UNUSED gen_event_loop_t* const restrict loop,
+        GEN_UNUSED gen_event_source_t* const restrict source)
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_remove, GEN_UNUSED gen_event_loop_t* const restrict loop,
+        GEN_UNUSED gen_event_source_t* const restrict source)
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_wake, GEN_UNUSED gen_event_loop_t* const restrict loop)
+GEN_LIBC_EVENT_NOT_IMPLEMENTED(
+        event_loop_wait, GEN_UNUSED gen_event_loop_t* const restrict loop,
+        GEN_UNUSED const gen_uint64_t timeout,
+        GEN_UNUSED gen_event_ready_t* const restrict out_ready,
+        GEN_UNUSED const gen_size_t limit,
+        GEN_UNUSED gen_size_t* const restrict out_count)
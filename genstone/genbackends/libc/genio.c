@@ -2,9 +2,286 @@
 // Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
 
 #include <gencommon.h>
+#include <genio.h>
 
 #include <genbackends.h>
+#include <genlibc.h>
 
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 GEN_BACKENDS_DEFER_NOGEN(terminal_write, void, libc, "puts", )
+
+// Opens and immediately closes `path` for the side effects of `mode`.
+static gen_error_t* gen_libc_file_internal_touch(
+        const char* const restrict path, const char* const restrict mode) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    FILE* const file = fopen(path, mode);
+    if(!file) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to open `%t`", path);
+    }
+
+    if(fclose(file)) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to open `%t`", path);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_open(
+        const char* const restrict path, const gen_file_access_t access,
+        gen_file_t* const restrict out_file) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // ISO C has no mode which creates a file without truncating it or which
+    // opens for writing without also reading, so we create the file up front
+    // by appending nothing and then open it normally.
+    if(access & GEN_FILE_ACCESS_CREATE) {
+        error = gen_libc_file_internal_touch(path, "ab");
+        if(error) return error;
+    }
+
+    // The append and truncating modes always create the file, so we check it
+    // exists before relying on them.
+    const gen_file_access_t creating =
+            GEN_FILE_ACCESS_APPEND | GEN_FILE_ACCESS_TRUNCATE;
+    if((access & creating) && !(access & GEN_FILE_ACCESS_CREATE)) {
+        error = gen_libc_file_internal_touch(path, "rb");
+        if(error) return error;
+    }
+
+    // Truncating is likewise done up front so that it combines with the
+    // other modes.
+    if(access & GEN_FILE_ACCESS_TRUNCATE) {
+        error = gen_libc_file_internal_touch(path, "wb");
+        if(error) return error;
+    }
+
+    const char* mode = access & GEN_FILE_ACCESS_WRITE ? "r+b" : "rb";
+
+    if(access & GEN_FILE_ACCESS_APPEND) {
+        mode = access & GEN_FILE_ACCESS_READ ? "a+b" : "ab";
+    }
+
+    FILE* const file = fopen(path, mode);
+    if(!file) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to open `%t`", path);
+    }
+
+    out_file->access = access;
+    out_file->native = (gen_uintptr_t) file;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_close(gen_file_t* const restrict file) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(fclose((FILE*) file->native)) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to close file");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_get_standard(
+        const gen_file_standard_t standard,
+        gen_file_t* const restrict out_file) {
+
+    FILE* const files[] = {
+        [GEN_FILE_STANDARD_INPUT] = stdin,
+        [GEN_FILE_STANDARD_OUTPUT] = stdout,
+        [GEN_FILE_STANDARD_ERROR] = stderr
+    };
+
+    out_file->native = (gen_uintptr_t) files[standard];
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_read(
+        const gen_file_t* const restrict file, void* const restrict buffer,
+        const gen_size_t size, gen_size_t* const restrict out_read) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    FILE* const native = (FILE*) file->native;
+
+    *out_read = fread(buffer, 1, size, native);
+    if(ferror(native)) {
+        clearerr(native);
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IO, GEN_LINE_STRING,
+                "Failed to read %uz bytes from file", size);
+    }
+
+    return GEN_NULL;
+}
+
+// Data is flushed out of the stdio buffer immediately as callers are expected
+// to do their own buffering.
+GEN_USED gen_error_t* gen_libc_file_write(
+        const gen_file_t* const restrict file,
+        const void* const restrict buffer, const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    FILE* const native = (FILE*) file->native;
+
+    if(fwrite(buffer, 1, size, native) != size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IO, GEN_LINE_STRING,
+                "Failed to write %uz bytes to file", size);
+    }
+
+    if(fflush(native)) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to flush written data");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_advise(
+        GEN_UNUSED const gen_file_t* const restrict file,
+        GEN_UNUSED const gen_file_advice_t advice) {
+
+    // ISO C has no means of passing on access patterns.
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_get_size(
+        const gen_file_t* const restrict file,
+        gen_size_t* const restrict out_size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    FILE* const native = (FILE*) file->native;
+
+    if(fseek(native, 0, SEEK_END)) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to seek to the end of the file");
+    }
+
+    const long size = ftell(native);
+    if(size < 0) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to get the position of the end of the file");
+    }
+
+    *out_size = (gen_size_t) size;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_mapping_sync(
+        const gen_file_mapping_t* const restrict mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    FILE* const native = (FILE*) mapping->file->native;
+
+    if(fseek(native, 0, SEEK_SET)) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to seek to the start of the file");
+    }
+
+    if(fwrite(mapping->data, 1, mapping->size, native) != mapping->size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IO, GEN_LINE_STRING,
+                "Failed to write back %uz bytes", mapping->size);
+    }
+
+    if(fflush(native)) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to flush written back data");
+    }
+
+    return GEN_NULL;
+}
+
+// We have no way to share pages with the file here, so mappings are emulated
+// by reading the whole file into a buffer and writing it back on sync/unmap.
+GEN_USED gen_error_t* gen_libc_file_map(
+        const gen_file_t* const restrict file,
+        GEN_UNUSED const gen_file_access_t access,
+        gen_file_mapping_t* const restrict out_mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    FILE* const native = (FILE*) file->native;
+
+    void* const data = malloc(out_mapping->size);
+    if(!data) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate %uz bytes for mapping", out_mapping->size);
+    }
+
+    if(fseek(native, 0, SEEK_SET)) {
+        free(data);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to seek to the start of the file");
+    }
+
+    if(fread(data, 1, out_mapping->size, native) != out_mapping->size) {
+        free(data);
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IO, GEN_LINE_STRING,
+                "Failed to read %uz bytes for mapping", out_mapping->size);
+    }
+
+    out_mapping->data = data;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_unmap(
+        gen_file_mapping_t* const restrict mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(mapping->access & GEN_FILE_ACCESS_WRITE) {
+        error = gen_libc_file_mapping_sync(mapping);
+        if(error) return error;
+    }
+
+    free(mapping->data);
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_file_mapping_advise(
+        GEN_UNUSED const gen_file_mapping_t* const restrict mapping,
+        GEN_UNUSED const gen_file_advice_t advice) {
+
+    // The whole file is already resident so there is nothing to advise.
+    return GEN_NULL;
+}
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genmetrics.h>
+
+#include <genbackends.h>
+
+#include <stdlib.h>
+
+// ISO C has no shared memory so metrics can only be read in-process.
+GEN_USED gen_error_t* gen_libc_metrics_map(
+        GEN_UNUSED const char* const restrict name, const gen_size_t size,
+        void** const restrict out_region) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    void* const region = calloc(1, size);
+    if(!region) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate metrics region");
+    }
+
+    *out_region = region;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_libc_metrics_unmap(
+        GEN_UNUSED const char* const restrict name, void* const restrict region,
+        GEN_UNUSED const gen_size_t size) {
+
+    free(region);
+
+    return GEN_NULL;
+}
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genprocess.h>
+
+#include <genbackends.h>
+
+// ISO C has no way to create processes.
+#define GEN_LIBC_PROCESS_NOT_IMPLEMENTED(func, ...) \
+    GEN_USED gen_error_t* gen_libc_##func(__VA_ARGS__) { \
+        gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME); \
+        GEN_TOOLING_AUTO gen_error_t* error; \
+        return gen_error_attach_backtrace( \
+                GEN_ERROR_NOT_IMPLEMENTED, GEN_LINE_STRING, \
+                "Processes are not supported on this platform"); \
+    }
+
+GEN_LIBC_PROCESS_NOT_IMPLEMENTED(
+        process_fork, GEN_UNUSED const gen_process_proc_t proc,
+        GEN_UNUSED void* const restrict user_data,
+        GEN_UNUSED gen_process_t* const restrict out_process)
+GEN_LIBC_PROCESS_NOT_IMPLEMENTED(
+        process_kill, GEN_UNUSED const gen_process_t* const restrict process)
+GEN_LIBC_PROCESS_NOT_IMPLEMENTED(
+        process_wait, GEN_UNUSED gen_process_t* const restrict process,
+        GEN_UNUSED gen_process_status_t* const restrict out_status)
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genrecorder.h>
+
+#include <genbackends.h>
+
+#include <signal.h>
+#include <stdio.h>
+
+// ISO C has no async-signal-safe output so this is best-effort when dumping
+// from a signal handler.
+GEN_USED void gen_libc_recorder_write(
+        const gen_file_t* const restrict file, const char* const restrict text,
+        const gen_size_t length) {
+
+    FILE* const stream = (FILE*) file->native;
+
+    fwrite(text, 1, length, stream);
+    fflush(stream);
+}
+
+static void gen_libc_recorder_internal_handle_signal(const int signal_number) {
+    gen_recorder_dump();
+
+    signal(signal_number, SIG_DFL);
+    raise(signal_number);
+}
+
+GEN_USED gen_error_t* gen_libc_recorder_install_signal_handlers(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // `SIGABRT` is left alone as `gen_abort` has already dumped by then.
+    const int signals[] = { SIGSEGV, SIGILL, SIGFPE };
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(signals); ++i) {
+        if(signal(signals[i], gen_libc_recorder_internal_handle_signal) ==
+           SIG_ERR) {
+
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                    "Failed to install handler for signal %si", signals[i]);
+        }
+    }
+
+    return GEN_NULL;
+}
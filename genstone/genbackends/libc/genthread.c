@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genthread.h>
+
+#include <genbackends.h>
+
+// ISO C threads are optional and absent from several of the libcs we target.
+#define GEN_LIBC_THREAD_NOT_IMPLEMENTED(func, ...) \
+    GEN_USED gen_error_t* gen_libc_##func(__VA_ARGS__) { \
+        gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME); \
+        GEN_TOOLING_AUTO gen_error_t* error; \
+        return gen_error_attach_backtrace( \
+                GEN_ERROR_NOT_IMPLEMENTED, GEN_LINE_STRING, \
+                "Threads are not supported on this platform"); \
+    }
+
+GEN_LIBC_THREAD_NOT_IMPLEMENTED(
+        thread_create, GEN_UNUSED const gen_thread_proc_t proc,
+        GEN_UNUSED void* const restrict user_data,
+        GEN_UNUSED gen_thread_t* const restrict out_thread)
+GEN_LIBC_THREAD_NOT_IMPLEMENTED(
+        thread_join, GEN_UNUSED gen_thread_t* const restrict thread,
+        GEN_UNUSED gen_bool_t* const restrict out_failed)
+
+GEN_USED gen_error_t* gen_libc_thread_get_processor_count(
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    *out_count = 1;
+
+    return GEN_NULL;
+}
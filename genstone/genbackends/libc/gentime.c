@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <gentime.h>
+
+#include <genbackends.h>
+
+#include <time.h>
+
+// ISO C only requires a wall clock, so this may jump with the system time
+// where the optional monotonic base isn't provided.
+#ifdef TIME_MONOTONIC
+#define GEN_LIBC_TIME_BASE TIME_MONOTONIC
+#else
+#define GEN_LIBC_TIME_BASE TIME_UTC
+#endif
+
+GEN_USED gen_error_t* gen_libc_time_get_monotonic(
+        gen_uint64_t* const restrict out_time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    struct timespec time;
+    if(timespec_get(&time, GEN_LIBC_TIME_BASE) != GEN_LIBC_TIME_BASE) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                "Failed to get the current time");
+    }
+
+    *out_time =
+            (gen_uint64_t) time.tv_sec * GEN_TIME_NANOSECONDS_PER_SECOND +
+            (gen_uint64_t) time.tv_nsec;
+
+    return GEN_NULL;
+}
+
+// There is no portable cycle counter so we count nanoseconds instead.
+GEN_USED gen_error_t* gen_libc_time_get_cycles(
+        gen_uint64_t* const restrict out_cycles) {
+
+    return gen_libc_time_get_monotonic(out_cycles);
+}
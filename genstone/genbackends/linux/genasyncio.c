@@ -0,0 +1,475 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genasyncio.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// If io_uring is unavailable (old kernels or where it has been disabled) we
+// perform requests synchronously at submission and queue their completions.
+typedef struct {
+    int fd;
+
+    void* submission_ring;
+    gen_size_t submission_ring_size;
+    void* completion_ring;
+    gen_size_t completion_ring_size;
+    struct io_uring_sqe* entries;
+    gen_size_t entries_size;
+
+    unsigned* submission_head;
+    unsigned* submission_tail;
+    unsigned* submission_mask;
+    unsigned* submission_array;
+
+    unsigned* completion_head;
+    unsigned* completion_tail;
+    unsigned* completion_mask;
+    struct io_uring_cqe* completions;
+
+    struct iovec* buffers;
+    gen_size_t buffers_count;
+
+    gen_async_io_completion_t* emulated;
+    gen_size_t emulated_head;
+    gen_size_t emulated_count;
+} gen_linux_async_io_queue_t;
+
+static void gen_linux_async_io_internal_unmap(
+        gen_linux_async_io_queue_t* const restrict native) {
+
+    if(native->entries) munmap(native->entries, native->entries_size);
+    if(native->completion_ring &&
+        native->completion_ring != native->submission_ring) {
+
+        munmap(native->completion_ring, native->completion_ring_size);
+    }
+    if(native->submission_ring) {
+        munmap(native->submission_ring, native->submission_ring_size);
+    }
+}
+
+static gen_error_t* gen_linux_async_io_internal_setup(
+        gen_linux_async_io_queue_t* const restrict native,
+        const gen_size_t depth) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    struct io_uring_params parameters = {0};
+    const long fd = syscall(
+            __NR_io_uring_setup, (unsigned) depth, &parameters);
+    if(fd == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to set up io_uring with %uz entries", depth);
+    }
+    native->fd = (int) fd;
+
+    native->submission_ring_size =
+            parameters.sq_off.array +
+            parameters.sq_entries * sizeof(unsigned);
+    native->completion_ring_size =
+            parameters.cq_off.cqes +
+            parameters.cq_entries * sizeof(struct io_uring_cqe);
+
+    const gen_bool_t single = parameters.features & IORING_FEAT_SINGLE_MMAP;
+    if(single) {
+        native->submission_ring_size = GEN_MAXIMUM(
+                native->submission_ring_size, native->completion_ring_size);
+        native->completion_ring_size = native->submission_ring_size;
+    }
+
+    native->submission_ring = mmap(
+            GEN_NULL, native->submission_ring_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, native->fd, IORING_OFF_SQ_RING);
+    if(native->submission_ring == MAP_FAILED) {
+        native->submission_ring = GEN_NULL;
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to map io_uring submission ring");
+    }
+
+    if(single) native->completion_ring = native->submission_ring;
+    else {
+        native->completion_ring = mmap(
+                GEN_NULL, native->completion_ring_size,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, native->fd,
+                IORING_OFF_CQ_RING);
+        if(native->completion_ring == MAP_FAILED) {
+            native->completion_ring = GEN_NULL;
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno),
+                    GEN_LINE_STRING,
+                    "Failed to map io_uring completion ring");
+        }
+    }
+
+    native->entries_size =
+            parameters.sq_entries * sizeof(struct io_uring_sqe);
+    native->entries = mmap(
+            GEN_NULL, native->entries_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, native->fd, IORING_OFF_SQES);
+    if(native->entries == MAP_FAILED) {
+        native->entries = GEN_NULL;
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to map io_uring submission entries");
+    }
+
+    gen_uint8_t* const submission = native->submission_ring;
+    native->submission_head = (unsigned*) (submission + parameters.sq_off.head);
+    native->submission_tail = (unsigned*) (submission + parameters.sq_off.tail);
+    native->submission_mask =
+            (unsigned*) (submission + parameters.sq_off.ring_mask);
+    native->submission_array =
+            (unsigned*) (submission + parameters.sq_off.array);
+
+    gen_uint8_t* const completion = native->completion_ring;
+    native->completion_head = (unsigned*) (completion + parameters.cq_off.head);
+    native->completion_tail = (unsigned*) (completion + parameters.cq_off.tail);
+    native->completion_mask =
+            (unsigned*) (completion + parameters.cq_off.ring_mask);
+    native->completions =
+            (struct io_uring_cqe*) (completion + parameters.cq_off.cqes);
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_async_io_queue_create(
+        const gen_size_t depth,
+        gen_async_io_queue_t* const restrict out_queue) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_async_io_queue_t* const native = calloc(1, sizeof(*native));
+    if(!native) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate async IO queue");
+    }
+    native->fd = -1;
+
+    error = gen_linux_async_io_internal_setup(native, depth);
+    if(error) {
+        gen_linux_async_io_internal_unmap(native);
+        if(native->fd != -1) close(native->fd);
+        native->fd = -1;
+
+        if(error->type != GEN_ERROR_NOT_IMPLEMENTED &&
+            error->type != GEN_ERROR_PERMISSION) {
+
+            free(native);
+            return error;
+        }
+
+        native->emulated = calloc(depth, sizeof(gen_async_io_completion_t));
+        if(!native->emulated) {
+            free(native);
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to allocate emulated completion queue");
+        }
+    }
+
+    out_queue->native = native;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_async_io_queue_destroy(
+        gen_async_io_queue_t* const restrict queue) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_async_io_queue_t* const native = queue->native;
+
+    if(native->fd != -1) {
+        gen_linux_async_io_internal_unmap(native);
+
+        if(close(native->fd) == -1) {
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno),
+                    GEN_LINE_STRING, "Failed to close io_uring");
+        }
+    }
+
+    free(native->buffers);
+    free(native->emulated);
+    free(native);
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_async_io_register_buffers(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_buffer_t* const restrict buffers,
+        const gen_size_t count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_async_io_queue_t* const native = queue->native;
+
+    if(native->fd == -1) return GEN_NULL;
+
+    if(native->buffers_count) {
+        const long result = syscall(
+                __NR_io_uring_register, native->fd,
+                IORING_UNREGISTER_BUFFERS, GEN_NULL, 0);
+        if(result == -1) {
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno),
+                    GEN_LINE_STRING, "Failed to unregister buffers");
+        }
+
+        free(native->buffers);
+        native->buffers = GEN_NULL;
+        native->buffers_count = 0;
+    }
+
+    if(!count) return GEN_NULL;
+
+    struct iovec* const vectors = calloc(count, sizeof(struct iovec));
+    if(!vectors) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate %uz buffer descriptions", count);
+    }
+
+    for(gen_size_t i = 0; i < count; ++i) {
+        vectors[i] = (struct iovec) { buffers[i].data, buffers[i].size };
+    }
+
+    const long result = syscall(
+            __NR_io_uring_register, native->fd, IORING_REGISTER_BUFFERS,
+            vectors, (unsigned) count);
+    if(result == -1) {
+        free(vectors);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to register %uz buffers", count);
+    }
+
+    native->buffers = vectors;
+    native->buffers_count = count;
+
+    return GEN_NULL;
+}
+
+static void gen_linux_async_io_internal_emulate(
+        gen_linux_async_io_queue_t* const restrict native,
+        const gen_size_t depth,
+        const gen_async_io_request_t* const restrict request) {
+
+    const int fd = (int) request->file->native;
+
+    ssize_t result = 0;
+    switch(request->operation) {
+        case GEN_ASYNC_IO_OPERATION_READ: {
+            result = pread(
+                    fd, request->buffer, request->size,
+                    (off_t) request->offset);
+            break;
+        }
+        case GEN_ASYNC_IO_OPERATION_WRITE: {
+            result = pwrite(
+                    fd, request->buffer, request->size,
+                    (off_t) request->offset);
+            break;
+        }
+        case GEN_ASYNC_IO_OPERATION_SYNC: {
+            result = fsync(fd);
+            break;
+        }
+    }
+
+    gen_async_io_completion_t* const completion =
+            &native->emulated[
+                (native->emulated_head + native->emulated_count) % depth];
+    ++native->emulated_count;
+
+    *completion = (gen_async_io_completion_t) {0};
+    completion->user_data = request->user_data;
+    if(result == -1) {
+        completion->failed = gen_true;
+        completion->error = gen_libc_internal_errno_error_type(errno);
+    }
+    else completion->transferred = (gen_size_t) result;
+}
+
+static GEN_FORCE_INLINE void gen_linux_async_io_internal_prepare(
+        gen_linux_async_io_queue_t* const restrict native,
+        struct io_uring_sqe* const restrict entry,
+        const gen_async_io_request_t* const restrict request) {
+
+    *entry = (struct io_uring_sqe) {0};
+    entry->fd = (int) request->file->native;
+    entry->user_data = (gen_uint64_t) request->user_data;
+
+    if(request->operation == GEN_ASYNC_IO_OPERATION_SYNC) {
+        entry->opcode = IORING_OP_FSYNC;
+        return;
+    }
+
+    const gen_bool_t read = request->operation == GEN_ASYNC_IO_OPERATION_READ;
+
+    entry->opcode = read ? IORING_OP_READ : IORING_OP_WRITE;
+    entry->addr = (gen_uint64_t) request->buffer;
+    entry->len = (gen_uint32_t) request->size;
+    entry->off = request->offset;
+
+    const gen_uint8_t* const start = request->buffer;
+    for(gen_size_t i = 0; i < native->buffers_count; ++i) {
+        const gen_uint8_t* const base = native->buffers[i].iov_base;
+        if(start >= base &&
+            start + request->size <= base + native->buffers[i].iov_len) {
+
+            entry->opcode = read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+            entry->buf_index = (gen_uint16_t) i;
+            break;
+        }
+    }
+}
+
+GEN_USED gen_error_t* gen_linux_async_io_submit(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_request_t* const restrict requests,
+        const gen_size_t count, gen_size_t* const restrict out_submitted) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_async_io_queue_t* const native = queue->native;
+
+    if(native->fd == -1) {
+        for(gen_size_t i = 0; i < count; ++i) {
+            gen_linux_async_io_internal_emulate(
+                    native, queue->depth, &requests[i]);
+        }
+        *out_submitted = count;
+
+        return GEN_NULL;
+    }
+
+    // We are the only producer so the tail can be read without ordering, the
+    // kernel only needs to see the entries before the new tail.
+    const unsigned mask = *native->submission_mask;
+    unsigned tail = *native->submission_tail;
+    for(gen_size_t i = 0; i < count; ++i) {
+        const unsigned index = tail & mask;
+        gen_linux_async_io_internal_prepare(
+                native, &native->entries[index], &requests[i]);
+        native->submission_array[index] = index;
+        ++tail;
+    }
+    __atomic_store_n(native->submission_tail, tail, __ATOMIC_RELEASE);
+
+    gen_size_t submitted = 0;
+    while(submitted < count) {
+        const long result = syscall(
+                __NR_io_uring_enter, native->fd,
+                (unsigned) (count - submitted), 0, 0, GEN_NULL, 0);
+        if(result == -1) {
+            if(errno == EINTR) continue;
+
+            // Take back whatever the kernel didn't consume so that it isn't
+            // picked up by a later submission.
+            __atomic_store_n(
+                    native->submission_tail,
+                    tail - (unsigned) (count - submitted), __ATOMIC_RELEASE);
+            *out_submitted = submitted;
+
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno),
+                    GEN_LINE_STRING, "Failed to submit %uz requests",
+                    count - submitted);
+        }
+
+        submitted += (gen_size_t) result;
+    }
+
+    *out_submitted = submitted;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_async_io_reap(
+        gen_async_io_queue_t* const restrict queue,
+        gen_async_io_completion_t* const restrict out_completions,
+        const gen_size_t limit, const gen_size_t minimum,
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_async_io_queue_t* const native = queue->native;
+
+    if(native->fd == -1) {
+        gen_size_t count = 0;
+        for(; count < limit && native->emulated_count; ++count) {
+            out_completions[count] = native->emulated[native->emulated_head];
+            native->emulated_head = (native->emulated_head + 1) % queue->depth;
+            --native->emulated_count;
+        }
+        *out_count = count;
+
+        return GEN_NULL;
+    }
+
+    const unsigned mask = *native->completion_mask;
+    unsigned head = *native->completion_head;
+
+    gen_size_t count = 0;
+    while(gen_true) {
+        const unsigned tail =
+                __atomic_load_n(native->completion_tail, __ATOMIC_ACQUIRE);
+
+        for(; head != tail && count < limit; ++head, ++count) {
+            const struct io_uring_cqe* const entry =
+                    &native->completions[head & mask];
+            gen_async_io_completion_t* const completion =
+                    &out_completions[count];
+
+            *completion = (gen_async_io_completion_t) {0};
+            completion->user_data = (void*) entry->user_data;
+            if(entry->res < 0) {
+                completion->failed = gen_true;
+                completion->error =
+                        gen_libc_internal_errno_error_type(-entry->res);
+            }
+            else completion->transferred = (gen_size_t) entry->res;
+        }
+        __atomic_store_n(native->completion_head, head, __ATOMIC_RELEASE);
+
+        if(count >= minimum) break;
+
+        const long result = syscall(
+                __NR_io_uring_enter, native->fd, 0,
+                (unsigned) (minimum - count), IORING_ENTER_GETEVENTS,
+                GEN_NULL, 0);
+        if(result == -1 && errno != EINTR) {
+            *out_count = count;
+
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno),
+                    GEN_LINE_STRING, "Failed to wait for completions");
+        }
+    }
+
+    *out_count = count;
+
+    return GEN_NULL;
+}
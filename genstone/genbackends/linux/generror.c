@@ -5,4 +5,29 @@
 
 #include <genbackends.h>
 
+#include <pthread.h>
+
 GEN_BACKENDS_DEFER(abort, void, linux, "libc", )
+
+static pthread_once_t gen_linux_error_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t gen_linux_error_key;
+static gen_bool_t gen_linux_error_key_valid = gen_false;
+
+static void gen_linux_error_internal_release(GEN_UNUSED void* const value) {
+    gen_error_internal_release_context();
+}
+
+static void gen_linux_error_internal_create_key(void) {
+    gen_linux_error_key_valid = !pthread_key_create(
+            &gen_linux_error_key, gen_linux_error_internal_release);
+}
+
+// Key destructors run for every thread which exits with a non-null value set,
+// however it was started. The main thread's context is left to the process.
+GEN_USED void gen_linux_error_watch_thread(void) {
+    pthread_once(
+            &gen_linux_error_key_once, gen_linux_error_internal_create_key);
+    if(!gen_linux_error_key_valid) return;
+
+    pthread_setspecific(gen_linux_error_key, &gen_linux_error_key);
+}
@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genevent.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+typedef struct {
+    int epoll;
+    int wake;
+} gen_linux_event_loop_t;
+
+GEN_USED gen_error_t* gen_linux_event_loop_create(
+        gen_event_loop_t* const restrict loop) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_event_loop_t* const native = malloc(sizeof(*native));
+    if(!native) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate event loop");
+    }
+
+    native->epoll = epoll_create1(EPOLL_CLOEXEC);
+    if(native->epoll == -1) {
+        free(native);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to create epoll instance");
+    }
+
+    native->wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(native->wake == -1) {
+        close(native->epoll);
+        free(native);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to create wakeup eventfd");
+    }
+
+    // The wakeup descriptor is told apart from sources by its null pointer.
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = GEN_NULL };
+    if(epoll_ctl(native->epoll, EPOLL_CTL_ADD, native->wake, &event) == -1) {
+        close(native->wake);
+        close(native->epoll);
+        free(native);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to register wakeup eventfd");
+    }
+
+    loop->native = native;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_event_loop_destroy(
+        gen_event_loop_t* const restrict loop) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_event_loop_t* const native = loop->native;
+
+    const int wake = close(native->wake);
+    const int epoll = close(native->epoll);
+    free(native);
+
+    if(wake == -1 || epoll == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to close event loop descriptors");
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_linux_event_loop_internal_control(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source, const int operation) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_event_loop_t* const native = loop->native;
+
+    struct epoll_event event = { .events = EPOLLRDHUP, .data.ptr = source };
+    if(source->interest & GEN_EVENT_READINESS_READABLE) event.events |= EPOLLIN;
+    if(source->interest & GEN_EVENT_READINESS_WRITABLE) {
+        event.events |= EPOLLOUT;
+    }
+
+    const int fd = (int) source->native;
+    if(epoll_ctl(native->epoll, operation, fd, &event) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to update interest for descriptor %si", fd);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_event_loop_add(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source) {
+
+    return gen_linux_event_loop_internal_control(loop, source, EPOLL_CTL_ADD);
+}
+
+GEN_USED gen_error_t* gen_linux_event_loop_modify(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source) {
+
+    return gen_linux_event_loop_internal_control(loop, source, EPOLL_CTL_MOD);
+}
+
+GEN_USED gen_error_t* gen_linux_event_loop_remove(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source) {
+
+    return gen_linux_event_loop_internal_control(loop, source, EPOLL_CTL_DEL);
+}
+
+GEN_USED gen_error_t* gen_linux_event_loop_wake(
+        gen_event_loop_t* const restrict loop) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_event_loop_t* const native = loop->native;
+
+    // A full counter already guarantees a pending wakeup.
+    const gen_uint64_t value = 1;
+    if(write(native->wake, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to signal wakeup eventfd");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_event_loop_wait(
+        gen_event_loop_t* const restrict loop, const gen_uint64_t timeout,
+        gen_event_ready_t* const restrict out_ready, const gen_size_t limit,
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_linux_event_loop_t* const native = loop->native;
+
+    struct epoll_event events[GEN_EVENT_LOOP_MAXIMUM_READY];
+    const int maximum = (int) GEN_MINIMUM(limit, GEN_ARRAY_LENGTH(events));
+    const int milliseconds =
+            timeout == GEN_EVENT_LOOP_INFINITE ? -1 :
+            (int) GEN_MINIMUM(timeout, (gen_uint64_t) INT_MAX);
+
+    const int count =
+            epoll_wait(native->epoll, events, maximum, milliseconds);
+    if(count == -1) {
+        // Signals interrupting the wait are treated as a spurious wakeup.
+        if(errno == EINTR) return GEN_NULL;
+
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to wait for events");
+    }
+
+    gen_size_t ready = 0;
+    for(int i = 0; i < count; ++i) {
+        const gen_uint32_t events_mask = events[i].events;
+
+        if(!events[i].data.ptr) {
+            gen_uint64_t value;
+            if(read(native->wake, &value, sizeof(value)) == -1 &&
+                errno != EAGAIN) {
+
+                return gen_error_attach_backtrace(
+                        gen_libc_internal_errno_error_type(errno),
+                        GEN_LINE_STRING, "Failed to drain wakeup eventfd");
+            }
+
+            continue;
+        }
+
+        gen_event_readiness_t readiness = 0;
+        if(events_mask & EPOLLIN) readiness |= GEN_EVENT_READINESS_READABLE;
+        if(events_mask & EPOLLOUT) readiness |= GEN_EVENT_READINESS_WRITABLE;
+        if(events_mask & (EPOLLHUP | EPOLLRDHUP)) {
+            readiness |= GEN_EVENT_READINESS_HANGUP;
+        }
+        if(events_mask & EPOLLERR) readiness |= GEN_EVENT_READINESS_ERROR;
+
+        out_ready[ready++] = (gen_event_ready_t) {
+            events[i].data.ptr, readiness
+        };
+    }
+
+    *out_count = ready;
+
+    return GEN_NULL;
+}
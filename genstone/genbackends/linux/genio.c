@@ -2,8 +2,249 @@
 // Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
 
 #include <gencommon.h>
+#include <genio.h>
 
 #include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 GEN_BACKENDS_DEFER(terminal_write, gen_error_t*, linux, "libc", return)
 
+GEN_USED gen_error_t* gen_linux_file_open(
+        const char* const restrict path, const gen_file_access_t access,
+        gen_file_t* const restrict out_file) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    int flags = O_CLOEXEC;
+
+    if((access & GEN_FILE_ACCESS_READ) && (access & GEN_FILE_ACCESS_WRITE)) {
+        flags |= O_RDWR;
+    }
+    else if(access & GEN_FILE_ACCESS_WRITE) flags |= O_WRONLY;
+    else flags |= O_RDONLY;
+
+    if(access & GEN_FILE_ACCESS_CREATE) flags |= O_CREAT;
+    if(access & GEN_FILE_ACCESS_APPEND) flags |= O_APPEND;
+    if(access & GEN_FILE_ACCESS_TRUNCATE) flags |= O_TRUNC;
+
+    const int fd = open(path, flags, 0666);
+    if(fd == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to open `%t`", path);
+    }
+
+    out_file->access = access;
+    out_file->native = (gen_uintptr_t) fd;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_close(gen_file_t* const restrict file) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(close((int) file->native) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to close file");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_get_standard(
+        const gen_file_standard_t standard,
+        gen_file_t* const restrict out_file) {
+
+    const int descriptors[] = {
+        [GEN_FILE_STANDARD_INPUT] = STDIN_FILENO,
+        [GEN_FILE_STANDARD_OUTPUT] = STDOUT_FILENO,
+        [GEN_FILE_STANDARD_ERROR] = STDERR_FILENO
+    };
+
+    out_file->native = (gen_uintptr_t) descriptors[standard];
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_read(
+        const gen_file_t* const restrict file, void* const restrict buffer,
+        const gen_size_t size, gen_size_t* const restrict out_read) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    ssize_t result;
+    do result = read((int) file->native, buffer, size);
+    while(result == -1 && errno == EINTR);
+
+    if(result == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to read %uz bytes from file", size);
+    }
+
+    *out_read = (gen_size_t) result;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_write(
+        const gen_file_t* const restrict file,
+        const void* const restrict buffer, const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_uint8_t* const bytes = buffer;
+
+    gen_size_t written = 0;
+    while(written < size) {
+        const ssize_t result = write(
+                (int) file->native, bytes + written, size - written);
+        if(result == -1) {
+            if(errno == EINTR) continue;
+
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno),
+                    GEN_LINE_STRING, "Failed to write %uz bytes to file",
+                    size - written);
+        }
+
+        written += (gen_size_t) result;
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_advise(
+        const gen_file_t* const restrict file,
+        const gen_file_advice_t advice) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const int advices[] = {
+        [GEN_FILE_ADVICE_NORMAL] = POSIX_FADV_NORMAL,
+        [GEN_FILE_ADVICE_SEQUENTIAL] = POSIX_FADV_SEQUENTIAL,
+        [GEN_FILE_ADVICE_RANDOM] = POSIX_FADV_RANDOM,
+        [GEN_FILE_ADVICE_WILL_NEED] = POSIX_FADV_WILLNEED,
+        [GEN_FILE_ADVICE_DONT_NEED] = POSIX_FADV_DONTNEED
+    };
+
+    // Advice is only a hint so pipes and the like just go without.
+    const int result =
+            posix_fadvise((int) file->native, 0, 0, advices[advice]);
+    if(result && result != ESPIPE) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(result), GEN_LINE_STRING,
+                "Failed to advise file");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_get_size(
+        const gen_file_t* const restrict file,
+        gen_size_t* const restrict out_size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    struct stat info;
+    if(fstat((int) file->native, &info) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to stat file");
+    }
+
+    *out_size = (gen_size_t) info.st_size;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_map(
+        const gen_file_t* const restrict file, const gen_file_access_t access,
+        gen_file_mapping_t* const restrict out_mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    int protection = PROT_READ;
+    if(access & GEN_FILE_ACCESS_WRITE) protection |= PROT_WRITE;
+
+    void* const data = mmap(
+            GEN_NULL, out_mapping->size, protection, MAP_SHARED,
+            (int) file->native, 0);
+    if(data == MAP_FAILED) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to map %uz bytes of file", out_mapping->size);
+    }
+
+    out_mapping->data = data;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_unmap(
+        gen_file_mapping_t* const restrict mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(munmap(mapping->data, mapping->size) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to unmap file mapping");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_mapping_advise(
+        const gen_file_mapping_t* const restrict mapping,
+        const gen_file_advice_t advice) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const int advices[] = {
+        [GEN_FILE_ADVICE_NORMAL] = MADV_NORMAL,
+        [GEN_FILE_ADVICE_SEQUENTIAL] = MADV_SEQUENTIAL,
+        [GEN_FILE_ADVICE_RANDOM] = MADV_RANDOM,
+        [GEN_FILE_ADVICE_WILL_NEED] = MADV_WILLNEED,
+        [GEN_FILE_ADVICE_DONT_NEED] = MADV_DONTNEED
+    };
+
+    if(madvise(mapping->data, mapping->size, advices[advice]) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to advise file mapping");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_file_mapping_sync(
+        const gen_file_mapping_t* const restrict mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(msync(mapping->data, mapping->size, MS_SYNC) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to sync file mapping");
+    }
+
+    return GEN_NULL;
+}
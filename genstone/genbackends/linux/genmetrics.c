@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genformat.h>
+#include <genmetrics.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// "/dev/shm/" + name
+#define GEN_LINUX_METRICS_PATH_LENGTH (9 + GEN_METRICS_NAME_LENGTH)
+
+static gen_error_t* gen_linux_metrics_internal_get_path(
+        const char* const restrict name, char* const restrict out_path) {
+
+    return gen_format(
+            out_path, GEN_NULL, GEN_LINUX_METRICS_PATH_LENGTH,
+            "/dev/shm/%t", name);
+}
+
+GEN_USED gen_error_t* gen_linux_metrics_map(
+        const char* const restrict name, const gen_size_t size,
+        void** const restrict out_region) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char path[GEN_LINUX_METRICS_PATH_LENGTH + 1] = {0};
+    error = gen_linux_metrics_internal_get_path(name, path);
+    if(error) return error;
+
+    // Another process' region must not be truncated out from under it.
+    const int fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if(fd == -1 && errno == EEXIST) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_ALREADY_EXISTS, GEN_LINE_STRING,
+                "Metrics file `%t` already exists", path);
+    }
+
+    if(fd == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to open metrics file `%t`", path);
+    }
+
+    if(ftruncate(fd, (off_t) size) == -1) {
+        close(fd);
+        unlink(path);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to size metrics file `%t`", path);
+    }
+
+    // The mapping keeps the file alive so the descriptor can go.
+    void* const region =
+            mmap(GEN_NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(region == MAP_FAILED) {
+        unlink(path);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to map metrics file `%t`", path);
+    }
+
+    *out_region = region;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_metrics_unmap(
+        const char* const restrict name, void* const restrict region,
+        const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char path[GEN_LINUX_METRICS_PATH_LENGTH + 1] = {0};
+    error = gen_linux_metrics_internal_get_path(name, path);
+    if(error) return error;
+
+    if(munmap(region, size) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to unmap metrics region");
+    }
+
+    if(unlink(path) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to remove metrics file `%t`", path);
+    }
+
+    return GEN_NULL;
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genprocess.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+GEN_USED gen_error_t* gen_linux_process_fork(
+        const gen_process_proc_t proc, void* const restrict user_data,
+        gen_process_t* const restrict out_process) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    int output[2];
+    if(pipe(output) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to create output pipe");
+    }
+
+    if(fcntl(output[0], F_SETFD, FD_CLOEXEC) == -1) {
+        close(output[0]);
+        close(output[1]);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to configure output pipe");
+    }
+
+    // Anything still buffered would otherwise be written by both processes.
+    fflush(GEN_NULL);
+
+    const pid_t pid = fork();
+    if(pid == -1) {
+        close(output[0]);
+        close(output[1]);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to fork process");
+    }
+
+    if(!pid) {
+        close(output[0]);
+        if(dup2(output[1], STDOUT_FILENO) == -1) _exit(1);
+        if(dup2(output[1], STDERR_FILENO) == -1) _exit(1);
+        close(output[1]);
+
+        // Output must reach the parent even if the child dies abruptly.
+        setvbuf(stdout, GEN_NULL, _IONBF, 0);
+
+        const gen_bool_t failed = !!proc(user_data);
+
+        fflush(GEN_NULL);
+        _exit(failed);
+    }
+
+    close(output[1]);
+
+    out_process->native = (gen_uintptr_t) pid;
+    out_process->output.native = (gen_uintptr_t) output[0];
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_process_kill(
+        const gen_process_t* const restrict process) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(kill((pid_t) process->native, SIGKILL) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to kill process %uz", process->native);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_process_wait(
+        gen_process_t* const restrict process,
+        gen_process_status_t* const restrict out_status) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    int status;
+    pid_t result;
+    do result = waitpid((pid_t) process->native, &status, 0);
+    while(result == -1 && errno == EINTR);
+
+    if(result == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to wait for process %uz", process->native);
+    }
+
+    if(WIFSIGNALED(status)) {
+        out_status->signalled = gen_true;
+        out_status->code = (gen_size_t) WTERMSIG(status);
+    }
+    else out_status->code = (gen_size_t) WEXITSTATUS(status);
+
+    return GEN_NULL;
+}
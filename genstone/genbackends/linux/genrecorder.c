@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genrecorder.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Dumping formats a backtrace, which needs more room than `MINSIGSTKSZ`.
+#ifndef GEN_LINUX_RECORDER_SIGNAL_STACK_SIZE
+#define GEN_LINUX_RECORDER_SIGNAL_STACK_SIZE 65536
+#endif
+
+// Dumps go through `write` directly as it is async-signal-safe. Failures are
+// dropped since there is nowhere left to report them.
+GEN_USED void gen_linux_recorder_write(
+        const gen_file_t* const restrict file, const char* const restrict text,
+        const gen_size_t length) {
+
+    gen_size_t written = 0;
+    while(written < length) {
+        const ssize_t result =
+                write((int) file->native, text + written, length - written);
+        if(result == -1 && errno == EINTR) continue;
+        if(result <= 0) return;
+
+        written += (gen_size_t) result;
+    }
+}
+
+static void gen_linux_recorder_internal_handle_signal(const int signal) {
+    gen_recorder_dump();
+
+    // `SA_RESETHAND` has restored the default action so this terminates us.
+    raise(signal);
+}
+
+GEN_USED gen_error_t* gen_linux_recorder_install_signal_handlers(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // A stack overflow leaves no room to run the handler on the faulting
+    // stack, so the calling thread is given an alternate one unless it
+    // already has its own. The stack is kept for the life of the thread.
+    stack_t current = {0};
+    if(sigaltstack(GEN_NULL, &current) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to query the alternate signal stack");
+    }
+
+    if(current.ss_flags & SS_DISABLE) {
+        stack_t stack = {0};
+        stack.ss_size = GEN_LINUX_RECORDER_SIGNAL_STACK_SIZE;
+        stack.ss_sp = malloc(stack.ss_size);
+        if(!stack.ss_sp) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to allocate an alternate signal stack");
+        }
+
+        if(sigaltstack(&stack, GEN_NULL) == -1) {
+            free(stack.ss_sp);
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                    "Failed to install an alternate signal stack");
+        }
+    }
+
+    // `SIGABRT` is left alone as `gen_abort` has already dumped by then.
+    const int signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE };
+
+    struct sigaction action = {0};
+    action.sa_handler = gen_linux_recorder_internal_handle_signal;
+    action.sa_flags = (int) (SA_RESETHAND | SA_NODEFER | SA_ONSTACK);
+    sigemptyset(&action.sa_mask);
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(signals); ++i) {
+        if(sigaction(signals[i], &action, GEN_NULL) == -1) {
+            return gen_error_attach_backtrace(
+                    gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                    "Failed to install handler for signal %si", signals[i]);
+        }
+    }
+
+    return GEN_NULL;
+}
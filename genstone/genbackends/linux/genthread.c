@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genthread.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    gen_thread_proc_t proc;
+    void* user_data;
+} gen_linux_thread_start_t;
+
+static void* gen_linux_thread_internal_start(void* const passthrough) {
+    gen_linux_thread_start_t start = *(gen_linux_thread_start_t*) passthrough;
+    free(passthrough);
+
+    const gen_bool_t failed = !!start.proc(start.user_data);
+
+    return (void*) (gen_uintptr_t) failed;
+}
+
+GEN_USED gen_error_t* gen_linux_thread_create(
+        const gen_thread_proc_t proc, void* const restrict user_data,
+        gen_thread_t* const restrict out_thread) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // The new thread takes ownership of this and frees it once started.
+    gen_linux_thread_start_t* const start = malloc(sizeof(*start));
+    if(!start) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate thread start parameters");
+    }
+
+    start->proc = proc;
+    start->user_data = user_data;
+
+    pthread_t thread;
+    const int result = pthread_create(
+            &thread, GEN_NULL, gen_linux_thread_internal_start, start);
+    if(result) {
+        free(start);
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(result), GEN_LINE_STRING,
+                "Failed to create thread");
+    }
+
+    out_thread->native = (gen_uintptr_t) thread;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_thread_join(
+        gen_thread_t* const restrict thread,
+        gen_bool_t* const restrict out_failed) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    void* status = GEN_NULL;
+    const int result = pthread_join((pthread_t) thread->native, &status);
+    if(result) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(result), GEN_LINE_STRING,
+                "Failed to join thread %uz", thread->native);
+    }
+
+    *out_failed = !!status;
+
+    return GEN_NULL;
+}
+
+GEN_USED gen_error_t* gen_linux_thread_get_processor_count(
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if(count == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to get processor count");
+    }
+
+    *out_count = count ? (gen_size_t) count : 1;
+
+    return GEN_NULL;
+}
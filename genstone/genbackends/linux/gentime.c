@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <gentime.h>
+
+#include <genbackends.h>
+#include <genlibc.h>
+
+#include <errno.h>
+#include <time.h>
+
+GEN_USED gen_error_t* gen_linux_time_get_monotonic(
+        gen_uint64_t* const restrict out_time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // This is serviced by the vDSO without entering the kernel.
+    struct timespec time;
+    if(clock_gettime(CLOCK_MONOTONIC, &time) == -1) {
+        return gen_error_attach_backtrace(
+                gen_libc_internal_errno_error_type(errno), GEN_LINE_STRING,
+                "Failed to get the monotonic time");
+    }
+
+    *out_time =
+            (gen_uint64_t) time.tv_sec * GEN_TIME_NANOSECONDS_PER_SECOND +
+            (gen_uint64_t) time.tv_nsec;
+
+    return GEN_NULL;
+}
+
+#if defined(__x86_64__) || defined(__aarch64__)
+GEN_USED gen_error_t* gen_linux_time_get_cycles(
+        gen_uint64_t* const restrict out_cycles) {
+
+    // The barriers stop the read from being hoisted above earlier work.
+#if defined(__x86_64__)
+    __builtin_ia32_lfence();
+    *out_cycles = __builtin_ia32_rdtsc();
+#else
+    gen_uint64_t cycles;
+    GEN_ASM_BLOCK(GEN_ASM(isb) GEN_ASM(mrs %0, cntvct_el0), : "=r" (cycles));
+    *out_cycles = cycles;
+#endif
+
+    return GEN_NULL;
+}
+#else
+GEN_BACKENDS_DEFER(time_get_cycles, gen_error_t*, linux, "libc", return)
+#endif
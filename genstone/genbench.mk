@@ -0,0 +1,28 @@
+GEN_BENCH_CFLAGS = $(GEN_CORE_CFLAGS)
+GEN_BENCH_CFLAGS += -I$(GENSTONE_DIR)/genstone/genbench/include
+GEN_BENCH_LFLAGS = $(GEN_CORE_LFLAGS) -lgenbench
+GEN_BENCH_LIBDIRS = $(GEN_CORE_LIBDIRS) $(GENSTONE_DIR)/lib
+
+GEN_BENCH_SOURCES = $(wildcard $(GENSTONE_DIR)/genstone/genbench/*.c)
+GEN_BENCH_OBJECTS = $(GEN_BENCH_SOURCES:.c=$(OBJECT_SUFFIX))
+
+GEN_BENCH_LIB = $(GENSTONE_DIR)/lib/$(LIB_PREFIX)genbench$(STATIC_LIB_SUFFIX)
+
+$(GEN_BENCH_LIB): CFLAGS = $(GEN_CORE_CFLAGS) $(GENSTONE_DIAGNOSTIC_CFLAGS)
+$(GEN_BENCH_LIB): LFLAGS = $(GEN_CORE_LFLAGS)
+$(GEN_BENCH_LIB): LIBDIRS = $(GEN_CORE_LIBDIRS)
+$(GEN_BENCH_LIB): $(GEN_BENCH_OBJECTS) | $(GENSTONE_DIR)/lib
+
+.PHONY: genbench
+genbench: $(GEN_BENCH_LIB)
+
+.PHONY: test_genbench
+test_genbench:
+
+.PHONY: bench_genbench
+bench_genbench:
+
+.PHONY: clean_genbench
+clean_genbench:
+	-$(RM) $(GEN_BENCH_OBJECTS)
+	-$(RM) $(GEN_BENCH_LIB)
@@ -0,0 +1,492 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_DISABLE
+#include "include/genbench.h"
+
+#include <genformat.h>
+#include <genio.h>
+#include <genstream.h>
+#include <gentime.h>
+
+gen_bench_unit_t gen_bench_list[GEN_BENCH_MAX] = {0};
+const char* gen_bench_name = GEN_BENCH_NAME;
+
+void gen_bench_internal_register(
+        const char* const restrict name, const char* const restrict unit,
+        const gen_bench_proc_t proc, const gen_size_t bytes) {
+
+    gen_bench_name = name;
+
+    gen_size_t i = 0;
+    for(; i < GEN_BENCH_MAX && gen_bench_list[i].present; ++i);
+    if(i >= GEN_BENCH_MAX) {
+        gen_log(
+                GEN_LOG_LEVEL_FATAL, name,
+                "Number of benchmarks exceeded maximum of %uz",
+                (gen_size_t) GEN_BENCH_MAX);
+        gen_abort();
+    }
+
+    gen_bench_list[i] = (gen_bench_unit_t) {gen_true, unit, proc, bytes};
+}
+
+// Percentage by which a median may exceed its baseline before it is
+// considered a regression.
+#ifndef GEN_BENCH_DEFAULT_THRESHOLD
+#define GEN_BENCH_DEFAULT_THRESHOLD 10
+#endif
+
+#define GEN_BENCH_PICOSECONDS_PER_SECOND 1000000000000ull
+
+// Times are in picoseconds per iteration so that very cheap bodies still get
+// meaningful figures.
+typedef struct {
+    gen_size_t iterations;
+
+    gen_uint64_t minimum;
+    gen_uint64_t median;
+    gen_uint64_t p99;
+
+    gen_uint64_t throughput;
+} gen_bench_result_t;
+
+static gen_bool_t gen_bench_internal_equal(
+        const char* const restrict a, const char* const restrict b,
+        const gen_size_t b_length) {
+
+    gen_size_t i = 0;
+    for(; i < b_length && a[i] && a[i] == b[i]; ++i);
+
+    return i == b_length && !a[i];
+}
+
+static gen_error_t* gen_bench_internal_parse(
+        const char* const restrict string, gen_uint64_t* const restrict out) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    *out = 0;
+    for(gen_size_t i = 0; string[i]; ++i) {
+        if(string[i] < '0' || string[i] > '9') {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "`%t` was not a number", string);
+        }
+
+        *out = *out * 10 + (gen_uint64_t) (string[i] - '0');
+    }
+
+    return GEN_NULL;
+}
+
+// Formats picoseconds as nanoseconds to three decimal places.
+static gen_error_t* gen_bench_internal_format_time(
+        const gen_uint64_t time, char* const restrict out_string,
+        const gen_size_t limit) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint64_t remainder = time % 1000;
+    char fraction[4] = {0};
+    for(gen_size_t i = 3; i--; remainder /= 10) {
+        fraction[i] = (char) ('0' + remainder % 10);
+    }
+
+    return gen_format(
+            out_string, GEN_NULL, limit, "%ul.%t", time / 1000, fraction);
+}
+
+static gen_error_t* gen_bench_internal_time(
+        const gen_bench_proc_t proc, const gen_size_t iterations,
+        gen_uint64_t* const restrict out_time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint64_t start = 0;
+    error = gen_time_get_cycles(&start);
+    if(error) return error;
+
+    error = proc(iterations);
+    if(error) return error;
+
+    gen_uint64_t end = 0;
+    error = gen_time_get_cycles(&end);
+    if(error) return error;
+
+    return gen_time_cycles_to_nanoseconds(end - start, out_time);
+}
+
+static gen_error_t* gen_bench_internal_run(
+        const gen_bench_unit_t* const restrict unit,
+        gen_bench_result_t* const restrict out_result) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // Lets the unit set up any state it builds lazily outside of the timings.
+    error = unit->proc(0);
+    if(error) return error;
+
+    gen_uint64_t time = 0;
+    gen_uint64_t spent = 0;
+
+    // Calibration also counts towards warming up.
+    gen_size_t iterations = 1;
+    while(gen_true) {
+        error = gen_bench_internal_time(unit->proc, iterations, &time);
+        if(error) return error;
+
+        spent += time;
+        if(time >= GEN_BENCH_SAMPLE_TIME || iterations > GEN_SIZE_MAX / 2) {
+            break;
+        }
+
+        iterations *= 2;
+    }
+
+    while(spent < GEN_BENCH_WARMUP_TIME) {
+        error = gen_bench_internal_time(unit->proc, iterations, &time);
+        if(error) return error;
+
+        spent += time;
+    }
+
+    gen_uint64_t samples[GEN_BENCH_SAMPLES] = {0};
+    for(gen_size_t i = 0; i < GEN_BENCH_SAMPLES; ++i) {
+        error = gen_bench_internal_time(unit->proc, iterations, &time);
+        if(error) return error;
+
+        const gen_uint64_t sample = time * 1000 / iterations;
+
+        gen_size_t j = i;
+        for(; j && samples[j - 1] > sample; --j) samples[j] = samples[j - 1];
+        samples[j] = sample;
+    }
+
+    *out_result = (gen_bench_result_t) {0};
+    out_result->iterations = iterations;
+    out_result->minimum = samples[0];
+    out_result->median = samples[GEN_BENCH_SAMPLES / 2];
+    out_result->p99 = samples[(GEN_BENCH_SAMPLES * 99 + 99) / 100 - 1];
+
+    if(unit->bytes && out_result->median) {
+        const gen_uint64_t bytes = unit->bytes;
+        const gen_uint64_t median = out_result->median;
+
+        out_result->throughput =
+                bytes <= GEN_UINT64_MAX / GEN_BENCH_PICOSECONDS_PER_SECOND ?
+                bytes * GEN_BENCH_PICOSECONDS_PER_SECOND / median :
+                bytes / median * GEN_BENCH_PICOSECONDS_PER_SECOND;
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_bench_internal_report(
+        const gen_bench_unit_t* const restrict unit,
+        const gen_bench_result_t* const restrict result) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char minimum[32] = {0};
+    char median[32] = {0};
+    char p99[32] = {0};
+
+    error = gen_bench_internal_format_time(
+            result->minimum, minimum, sizeof(minimum) - 1);
+    if(error) return error;
+
+    error = gen_bench_internal_format_time(
+            result->median, median, sizeof(median) - 1);
+    if(error) return error;
+
+    error = gen_bench_internal_format_time(result->p99, p99, sizeof(p99) - 1);
+    if(error) return error;
+
+    error = gen_log(
+            GEN_LOG_LEVEL_INFO, gen_bench_name,
+            "%t: min %t ns, median %t ns, p99 %t ns (%uz x %uz iterations)",
+            unit->name, minimum, median, p99, (gen_size_t) GEN_BENCH_SAMPLES,
+            result->iterations);
+    if(error) return error;
+
+    if(result->throughput) {
+        error = gen_log(
+                GEN_LOG_LEVEL_INFO, gen_bench_name, "%t: %ul MB/s",
+                unit->name, result->throughput / 1000000);
+        if(error) return error;
+    }
+
+    return GEN_NULL;
+}
+
+// Results are written one unit per line as tab-separated fields:
+// name, iterations per sample, min, median and p99 in picoseconds per
+// iteration, then throughput in bytes per second (0 if not applicable).
+static gen_error_t* gen_bench_internal_write_result(
+        gen_stream_writer_t* const restrict writer,
+        const gen_bench_unit_t* const restrict unit,
+        const gen_bench_result_t* const restrict result) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char line[512] = {0};
+    gen_size_t length = 0;
+    error = gen_format(
+            line, &length, sizeof(line) - 1, "%t\t%uz\t%ul\t%ul\t%ul\t%ul\n",
+            unit->name, result->iterations, result->minimum, result->median,
+            result->p99, result->throughput);
+    if(error) return error;
+
+    if(length > sizeof(line) - 1) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "Result line for `%t` was too long", unit->name);
+    }
+
+    return gen_stream_writer_write(writer, line, length);
+}
+
+static gen_error_t* gen_bench_internal_find_baseline(
+        const gen_file_mapping_t* const restrict baseline,
+        const char* const restrict name,
+        gen_uint64_t* const restrict out_median,
+        gen_bool_t* const restrict out_found) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    *out_found = gen_false;
+
+    const char* const data = baseline->data;
+    gen_size_t line = 0;
+    while(line < baseline->size) {
+        // Fields are copied out so that they can be handled as strings.
+        char fields[6][128] = {0};
+        gen_size_t lengths[6] = {0};
+        gen_size_t field = 0;
+
+        gen_size_t end = line;
+        for(; end < baseline->size && data[end] != '\n'; ++end) {
+            if(field >= GEN_ARRAY_LENGTH(fields)) continue;
+
+            if(data[end] == '\t') ++field;
+            else if(lengths[field] < sizeof(fields[field]) - 1) {
+                fields[field][lengths[field]++] = data[end];
+            }
+        }
+
+        if(field == GEN_ARRAY_LENGTH(fields) - 1 &&
+            gen_bench_internal_equal(name, fields[0], lengths[0])) {
+
+            error = gen_bench_internal_parse(fields[3], out_median);
+            if(error) return error;
+
+            *out_found = gen_true;
+            return GEN_NULL;
+        }
+
+        line = end + 1;
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_bench_internal_compare(
+        const gen_file_mapping_t* const restrict baseline,
+        const gen_uint64_t threshold,
+        const gen_bench_unit_t* const restrict unit,
+        const gen_bench_result_t* const restrict result,
+        gen_bool_t* const restrict out_regressed) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    *out_regressed = gen_false;
+
+    gen_uint64_t median = 0;
+    gen_bool_t found = gen_false;
+    error = gen_bench_internal_find_baseline(
+            baseline, unit->name, &median, &found);
+    if(error) return error;
+
+    if(!found || !median) {
+        return gen_log(
+                GEN_LOG_LEVEL_WARNING, gen_bench_name,
+                "%t: No baseline to compare against", unit->name);
+    }
+
+    const gen_bool_t slower = result->median > median;
+    const gen_uint64_t difference =
+            slower ? result->median - median : median - result->median;
+    const gen_uint64_t percentage = difference * 100 / median;
+
+    *out_regressed = slower && percentage > threshold;
+
+    return gen_log(
+            *out_regressed ? GEN_LOG_LEVEL_ERROR : GEN_LOG_LEVEL_INFO,
+            gen_bench_name, "%t: %ul%% %t than baseline%t", unit->name,
+            percentage, slower ? "slower" : "faster",
+            *out_regressed ? " - regression!" : "");
+}
+
+static gen_error_t* gen_bench_internal_main(
+        const gen_size_t argc, const char* const* const argv) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // Progress for every unit is logged from the same call sites, so rate
+    // limiting would drop the lines saying which unit a result belongs to.
+    error = gen_log_set_rate_limit(0, 0);
+    if(error) return error;
+
+    const char* output_path = GEN_NULL;
+    const char* baseline_path = GEN_NULL;
+    gen_uint64_t threshold = GEN_BENCH_DEFAULT_THRESHOLD;
+
+    for(gen_size_t i = 1; i < argc; i += 2) {
+        const char* const option = argv[i];
+        if(i + 1 >= argc) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "Option `%t` was missing a value", option);
+        }
+
+        const char* const value = argv[i + 1];
+
+        if(gen_bench_internal_equal(option, "--output", 8)) {
+            output_path = value;
+        }
+        else if(gen_bench_internal_equal(option, "--baseline", 10)) {
+            baseline_path = value;
+        }
+        else if(gen_bench_internal_equal(option, "--threshold", 11)) {
+            error = gen_bench_internal_parse(value, &threshold);
+            if(error) return error;
+        }
+        else {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "Unknown option `%t`", option);
+        }
+    }
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    gen_file_t output_file = {0};
+    gen_stream_writer_t output = {0};
+    if(output_path) {
+        error = gen_file_open(
+                output_path,
+                GEN_FILE_ACCESS_WRITE | GEN_FILE_ACCESS_CREATE |
+                GEN_FILE_ACCESS_TRUNCATE,
+                &output_file);
+        if(error) return error;
+
+        error = gen_stream_writer_create(&allocator, &output_file, 0, &output);
+        if(error) return error;
+    }
+
+    gen_file_t baseline_file = {0};
+    gen_file_mapping_t baseline = {0};
+    if(baseline_path) {
+        error = gen_file_open(
+                baseline_path, GEN_FILE_ACCESS_READ, &baseline_file);
+        if(error) return error;
+
+        error = gen_file_map(&baseline_file, GEN_FILE_ACCESS_READ, &baseline);
+        if(error) return error;
+    }
+
+    gen_size_t len = 0;
+    for(; len < GEN_BENCH_MAX && gen_bench_list[len].present; ++len);
+
+    gen_bool_t had_failure = gen_false;
+    gen_bool_t had_regression = gen_false;
+    for(gen_size_t i = 0; i < len; ++i) {
+        const gen_bench_unit_t* const unit = &gen_bench_list[i];
+
+        gen_log(
+                GEN_LOG_LEVEL_INFO, gen_bench_name,
+                "Benchmarking %t... [%uz/%uz]", unit->name, i + 1, len);
+
+        gen_bench_result_t result = {0};
+        error = gen_bench_internal_run(unit, &result);
+        if(error) {
+            gen_log(GEN_LOG_LEVEL_ERROR, gen_bench_name, "%e", error);
+            gen_log(GEN_LOG_LEVEL_ERROR, gen_bench_name, "Failed!");
+            had_failure = gen_true;
+            continue;
+        }
+
+        error = gen_bench_internal_report(unit, &result);
+        if(error) return error;
+
+        if(output_path) {
+            error = gen_bench_internal_write_result(&output, unit, &result);
+            if(error) return error;
+        }
+
+        if(baseline_path) {
+            gen_bool_t regressed = gen_false;
+            error = gen_bench_internal_compare(
+                    &baseline, threshold, unit, &result, &regressed);
+            if(error) return error;
+
+            if(regressed) had_regression = gen_true;
+        }
+    }
+
+    if(output_path) {
+        error = gen_stream_writer_destroy(&output);
+        if(error) return error;
+
+        error = gen_file_close(&output_file);
+        if(error) return error;
+    }
+
+    if(baseline_path) {
+        error = gen_file_unmap(&baseline);
+        if(error) return error;
+
+        error = gen_file_close(&baseline_file);
+        if(error) return error;
+    }
+
+    if(had_failure) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                "Benchmark suite failed");
+    }
+
+    if(had_regression) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_TIMING, GEN_LINE_STRING,
+                "Benchmark suite regressed against baseline");
+    }
+
+    return GEN_NULL;
+}
+
+int main(int argc, char** argv) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_bench_internal_main(
+            (gen_size_t) argc, (const char* const*) argv);
+    if(error) {
+        gen_log(GEN_LOG_LEVEL_FATAL, gen_bench_name, "%e", error);
+        gen_abort();
+    }
+
+    gen_log(GEN_LOG_LEVEL_INFO, gen_bench_name, "All units measured");
+}
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_BENCH_H
+#define GEN_BENCH_H
+
+#include <gencommon.h>
+#include <genlog.h>
+
+// A benchmark body runs its measured operation `iterations` times. Each body
+// is first called once untimed with no iterations, so any state it sets up
+// lazily is not measured.
+typedef gen_error_t* (*gen_bench_proc_t)(const gen_size_t);
+
+#ifndef GEN_BENCH_NAME
+#define GEN_BENCH_NAME "unnamed-bench"
+#endif
+
+// Bytes processed per iteration, used to report throughput.
+#ifndef GEN_BENCH_BYTES
+#define GEN_BENCH_BYTES 0
+#endif
+
+#define GEN_BENCH_MAX 512
+
+// Nanoseconds spent running the body before measuring.
+#ifndef GEN_BENCH_WARMUP_TIME
+#define GEN_BENCH_WARMUP_TIME 100000000ull
+#endif
+
+// Iteration counts are doubled until a single sample takes at least this many
+// nanoseconds.
+#ifndef GEN_BENCH_SAMPLE_TIME
+#define GEN_BENCH_SAMPLE_TIME 5000000ull
+#endif
+
+#ifndef GEN_BENCH_SAMPLES
+#define GEN_BENCH_SAMPLES 100
+#endif
+
+typedef struct {
+    gen_bool_t present;
+    const char* name;
+    gen_bench_proc_t proc;
+    gen_size_t bytes;
+} gen_bench_unit_t;
+
+extern gen_bench_unit_t gen_bench_list[GEN_BENCH_MAX];
+extern const char* gen_bench_name;
+
+void gen_bench_internal_register(
+        const char* const restrict name, const char* const restrict unit,
+        const gen_bench_proc_t proc, const gen_size_t bytes);
+
+// Keeps the compiler from discarding a computation whose result is otherwise
+// unused.
+#define GEN_BENCH_KEEP(x) GEN_ASM_BLOCK("", : : "g" (x) : "memory")
+
+// Defines a unit named `unit` with the body which follows, for files which
+// measure several things side by side, such as an implementation and the
+// baseline it is compared against. Unit names must be unique among everything
+// linked into one runner.
+#define GEN_BENCH_DEFINE(proc, unit, bytes) \
+    static gen_error_t* proc(const gen_size_t iterations); \
+    GEN_INITIALIZER static void gen_bench_internal_register_##proc(void) { \
+        gen_bench_internal_register(GEN_BENCH_NAME, unit, proc, bytes); \
+    } \
+    static gen_error_t* proc(const gen_size_t iterations)
+
+// Files defining `GEN_BENCH_UNIT` have a single unit whose body is
+// `gen_bench`.
+#if defined(GEN_BENCH_UNIT) && !defined(GEN_BENCH_DISABLE)
+static gen_error_t* gen_bench(const gen_size_t iterations);
+
+GEN_INITIALIZER static void gen_bench_internal_register_bench(void) {
+    gen_bench_internal_register(
+            GEN_BENCH_NAME, GEN_BENCH_UNIT, gen_bench, GEN_BENCH_BYTES);
+}
+#endif
+
+#endif
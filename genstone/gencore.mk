@@ -22,13 +22,50 @@ $(GEN_CORE_LIB): LFLAGS = $(GEN_CORE_INTERNAL_LFLAGS)
 $(GEN_CORE_LIB): LIBDIRS = $(GEN_BACKENDS_LIBDIRS)
 $(GEN_CORE_LIB): $(GEN_CORE_OBJECTS) $(GEN_BACKENDS_LIB) | $(GENSTONE_DIR)/lib
 
+# Test units are linked into a single runner which runs each of them in its
+# own process.
+GEN_CORE_TESTS_SOURCES = \
+	$(wildcard $(GENSTONE_DIR)/genstone/gencore/tests/*.c)
+GEN_CORE_TESTS_OBJECTS = $(GEN_CORE_TESTS_SOURCES:.c=$(OBJECT_SUFFIX))
+
+GEN_CORE_TESTS = \
+	$(GENSTONE_DIR)/genstone/gencore/tests/gencoretests$(EXECUTABLE_SUFFIX)
+
+$(GEN_CORE_TESTS): CFLAGS = $(GEN_TESTS_CFLAGS) $(GENSTONE_DIAGNOSTIC_CFLAGS)
+$(GEN_CORE_TESTS): LFLAGS = $(GEN_TESTS_LFLAGS)
+$(GEN_CORE_TESTS): LIBDIRS = $(GEN_TESTS_LIBDIRS)
+$(GEN_CORE_TESTS): $(GEN_CORE_TESTS_OBJECTS) $(GEN_TESTS_LIB) $(GEN_CORE_LIB)
+
+# Benchmark units are linked into a single runner so that one results file
+# covers all of them.
+GEN_CORE_BENCH_SOURCES = \
+	$(wildcard $(GENSTONE_DIR)/genstone/gencore/benchmarks/*.c)
+GEN_CORE_BENCH_OBJECTS = $(GEN_CORE_BENCH_SOURCES:.c=$(OBJECT_SUFFIX))
+
+GEN_CORE_BENCH = \
+	$(GENSTONE_DIR)/genstone/gencore/benchmarks/gencorebench$(EXECUTABLE_SUFFIX)
+
+$(GEN_CORE_BENCH): CFLAGS = $(GEN_BENCH_CFLAGS) $(GENSTONE_DIAGNOSTIC_CFLAGS)
+$(GEN_CORE_BENCH): LFLAGS = $(GEN_BENCH_LFLAGS)
+$(GEN_CORE_BENCH): LIBDIRS = $(GEN_BENCH_LIBDIRS)
+$(GEN_CORE_BENCH): $(GEN_CORE_BENCH_OBJECTS) $(GEN_BENCH_LIB) $(GEN_CORE_LIB)
+
 .PHONY: gencore
 gencore: $(GEN_CORE_LIB)
 
 .PHONY: test_gencore
-test_gencore:
+test_gencore: $(GEN_CORE_TESTS)
+	$(GEN_CORE_TESTS) $(TEST_FLAGS)
+
+.PHONY: bench_gencore
+bench_gencore: $(GEN_CORE_BENCH)
+	$(GEN_CORE_BENCH) $(BENCH_FLAGS)
 
 .PHONY: clean_gencore
 clean_gencore:
 	-$(RM) $(GEN_CORE_OBJECTS)
 	-$(RM) $(GEN_CORE_LIB)
+	-$(RM) $(GEN_CORE_TESTS_OBJECTS)
+	-$(RM) $(GEN_CORE_TESTS)
+	-$(RM) $(GEN_CORE_BENCH_OBJECTS)
+	-$(RM) $(GEN_CORE_BENCH)
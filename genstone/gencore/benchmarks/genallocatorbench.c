@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_NAME "gencore"
+#include <genbench.h>
+
+#include <genallocator.h>
+
+GEN_BENCH_DEFINE(gen_allocator_bench_small, "genallocator-small", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        void* const allocation = allocator.malloc(64);
+        if(!allocation) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to allocate benchmark block");
+        }
+
+        GEN_BENCH_KEEP(allocation);
+        allocator.free(allocation);
+    }
+
+    return GEN_NULL;
+}
+
+// Keeps a window of live allocations of varying sizes, as a long running
+// program would, rather than freeing each one straight away.
+GEN_BENCH_DEFINE(gen_allocator_bench_mixed, "genallocator-mixed", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    void* live[64] = {0};
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        const gen_size_t slot = (i * 37) % GEN_ARRAY_LENGTH(live);
+        allocator.free(live[slot]);
+
+        live[slot] = allocator.malloc(16 + (i * 0x9E3779B9 >> 7) % 4096);
+        if(!live[slot]) {
+            for(gen_size_t j = 0; j < GEN_ARRAY_LENGTH(live); ++j) {
+                allocator.free(live[j]);
+            }
+
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to allocate benchmark block");
+        }
+    }
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(live); ++i) {
+        allocator.free(live[i]);
+    }
+
+    return GEN_NULL;
+}
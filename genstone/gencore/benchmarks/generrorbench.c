@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_NAME "gencore"
+#include <genbench.h>
+
+// Raising is kept out of line so that the cost of capturing the backtrace and
+// formatting the context is measured as callers see it.
+static GEN_NO_INLINE gen_error_t* gen_error_bench_internal_raise(
+        const gen_size_t value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    return gen_error_attach_backtrace(
+            GEN_ERROR_OUT_OF_BOUNDS, GEN_LINE_STRING,
+            "Value %uz exceeded the benchmark's limit", value);
+}
+
+GEN_BENCH_DEFINE(gen_error_bench_raise, "generror-raise", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        gen_error_t* const raised = gen_error_bench_internal_raise(i);
+        GEN_BENCH_KEEP(raised);
+    }
+
+    return GEN_NULL;
+}
+
+// Frames between the outermost caller and the function which fails, about as
+// many as separate a public entry point from a backend call.
+#define GEN_ERROR_BENCH_DEPTH 16
+
+// Each level is kept out of line and touches `depth` after its call returns so
+// that the chain can neither be inlined nor turned into tail calls.
+static GEN_NO_INLINE gen_error_t* gen_error_bench_internal_try(
+        const gen_size_t depth, const gen_bool_t fail) {
+
+    gen_error_t* error = GEN_NULL;
+
+    if(!depth) {
+        if(!fail) return GEN_NULL;
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                "Innermost call failed");
+    }
+
+    GEN_TRY(gen_error_bench_internal_try(depth - 1, fail));
+    GEN_BENCH_KEEP(depth);
+
+    return error;
+}
+
+// `GEN_FAILPOINT` cannot be measured as written: `gen_jump_point_t` is a
+// single word where `__builtin_setjmp` stores five, and the failpoint is
+// scoped to the macro so callees have nothing to jump to. This reproduces the
+// scheme it describes with a full buffer and a per-thread chain of failpoints,
+// each of which forwards a failure to the one above it.
+typedef struct gen_error_bench_failpoint_t {
+    void* point[5];
+    gen_error_type_t type;
+    struct gen_error_bench_failpoint_t* previous;
+} gen_error_bench_failpoint_t;
+
+static GEN_THREAD_LOCAL gen_error_bench_failpoint_t*
+        gen_error_bench_failpoint = GEN_NULL;
+
+static GEN_NO_INLINE void gen_error_bench_internal_fail(
+        const gen_size_t depth, const gen_bool_t fail) {
+
+    if(!depth) {
+        if(!fail) return;
+
+        gen_error_bench_failpoint->type = GEN_ERROR_OPERATION_FAILED;
+        gen_goto_jump_point(gen_error_bench_failpoint->point);
+    }
+
+    gen_error_bench_failpoint_t failpoint = {0};
+    failpoint.previous = gen_error_bench_failpoint;
+    gen_error_bench_failpoint = &failpoint;
+
+    if(gen_set_jump_point(failpoint.point)) {
+        gen_error_bench_failpoint = failpoint.previous;
+        gen_error_bench_failpoint->type = failpoint.type;
+        gen_goto_jump_point(gen_error_bench_failpoint->point);
+    }
+
+    gen_error_bench_internal_fail(depth - 1, fail);
+    gen_error_bench_failpoint = failpoint.previous;
+    GEN_BENCH_KEEP(depth);
+}
+
+// The outermost failpoint turns the jump back into a returned error, as
+// `GEN_FAILPOINT` does in every function which uses it.
+static GEN_NO_INLINE gen_error_t* gen_error_bench_internal_failpoint(
+        const gen_size_t depth, const gen_bool_t fail) {
+
+    gen_error_bench_failpoint_t failpoint = {0};
+    failpoint.previous = gen_error_bench_failpoint;
+    gen_error_bench_failpoint = &failpoint;
+
+    if(gen_set_jump_point(failpoint.point)) {
+        gen_error_bench_failpoint = failpoint.previous;
+
+        return gen_error_attach_backtrace(
+                failpoint.type, GEN_LINE_STRING, "Nested call failure");
+    }
+
+    gen_error_bench_internal_fail(depth, fail);
+    gen_error_bench_failpoint = failpoint.previous;
+
+    return GEN_NULL;
+}
+
+typedef gen_error_t* (*gen_error_bench_chain_t)(
+        const gen_size_t, const gen_bool_t);
+
+static gen_error_t* gen_error_bench_internal_run(
+        const gen_size_t iterations, const gen_error_bench_chain_t chain,
+        const gen_bool_t fail) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        gen_error_t* const result = chain(GEN_ERROR_BENCH_DEPTH, fail);
+        if(!result != !fail) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                    "Call chain %t when it should have %t",
+                    result ? "failed" : "succeeded",
+                    fail ? "failed" : "succeeded");
+        }
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(gen_error_bench_try_success, "generror-try-success", 0) {
+    return gen_error_bench_internal_run(
+            iterations, gen_error_bench_internal_try, gen_false);
+}
+
+GEN_BENCH_DEFINE(gen_error_bench_try_failure, "generror-try-failure", 0) {
+    return gen_error_bench_internal_run(
+            iterations, gen_error_bench_internal_try, gen_true);
+}
+
+GEN_BENCH_DEFINE(
+        gen_error_bench_failpoint_success, "generror-failpoint-success", 0) {
+
+    return gen_error_bench_internal_run(
+            iterations, gen_error_bench_internal_failpoint, gen_false);
+}
+
+GEN_BENCH_DEFINE(
+        gen_error_bench_failpoint_failure, "generror-failpoint-failure", 0) {
+
+    return gen_error_bench_internal_run(
+            iterations, gen_error_bench_internal_failpoint, gen_true);
+}
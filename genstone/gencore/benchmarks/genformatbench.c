@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_NAME "gencore"
+#include <genbench.h>
+
+#include <genformat.h>
+
+GEN_BENCH_DEFINE(gen_format_bench_numbers, "genformat-numbers", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char buffer[128] = {0};
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        gen_size_t length = 0;
+        error = gen_format(
+                buffer, &length, sizeof(buffer) - 1, "%uz %sz %ui",
+                i * 0x9E3779B97F4A7C15ull, -(gen_ssize_t) i, (gen_uint_t) i);
+        if(error) return error;
+
+        GEN_BENCH_KEEP(length);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(gen_format_bench_strings, "genformat-strings", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char buffer[128] = {0};
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        gen_size_t length = 0;
+        error = gen_format(
+                buffer, &length, sizeof(buffer) - 1, "[%t%cz] %t",
+                "genformat", ' ', (gen_size_t) 8,
+                "a short message of the kind logs are made of");
+        if(error) return error;
+
+        GEN_BENCH_KEEP(length);
+    }
+
+    return GEN_NULL;
+}
+
+// Long output goes through the growable builder rather than a fixed buffer.
+GEN_BENCH_DEFINE(gen_format_bench_builder, "genformat-builder", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    GEN_STRING_BUILDER_AUTO gen_string_builder_t builder = {0};
+    error = gen_string_builder_create(&allocator, &builder);
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        error = gen_string_builder_truncate(&builder, 0);
+        if(error) return error;
+
+        for(gen_size_t j = 0; j < 16; ++j) {
+            error = gen_string_builder_format(
+                    &builder, "%t %uz, ", "entry", j);
+            if(error) return error;
+        }
+
+        GEN_BENCH_KEEP(builder.length);
+    }
+
+    return GEN_NULL;
+}
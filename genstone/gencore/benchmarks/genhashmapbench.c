@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_NAME "gencore"
+#include <genbench.h>
+
+#include <genhashmap.h>
+
+// Entries held by each table. Large enough to fall out of the L2 cache.
+#define GEN_HASHMAP_BENCH_ENTRIES 65536
+
+// Present keys are the even-indexed outputs of an odd multiplier, which is a
+// bijection, and misses the odd-indexed ones, so the two never collide.
+static gen_uint64_t gen_hashmap_bench_internal_key(const gen_size_t index) {
+    return index * 0x9E3779B97F4A7C15ull;
+}
+
+// The baseline: a bucket array of singly linked nodes allocated one by one,
+// as most hand-rolled tables are.
+typedef struct gen_hashmap_bench_node_t {
+    gen_uint64_t key;
+    gen_uint64_t value;
+    struct gen_hashmap_bench_node_t* next;
+} gen_hashmap_bench_node_t;
+
+typedef struct {
+    gen_system_allocator_t allocator;
+    gen_hashmap_bench_node_t** buckets;
+    gen_size_t mask;
+} gen_hashmap_bench_chaining_t;
+
+static gen_hashmap_bench_node_t** gen_hashmap_bench_internal_bucket(
+        const gen_hashmap_bench_chaining_t* const restrict table,
+        const gen_uint64_t key) {
+
+    const gen_uint64_t hash = (key ^ (key >> 29)) * 0xBF58476D1CE4E5B9ull;
+    return &table->buckets[(hash >> 32) & table->mask];
+}
+
+static gen_error_t* gen_hashmap_bench_internal_chaining_insert(
+        gen_hashmap_bench_chaining_t* const restrict table,
+        const gen_uint64_t key, const gen_uint64_t value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_hashmap_bench_node_t** const bucket =
+            gen_hashmap_bench_internal_bucket(table, key);
+
+    for(gen_hashmap_bench_node_t* node = *bucket; node; node = node->next) {
+        if(node->key == key) {
+            node->value = value;
+            return GEN_NULL;
+        }
+    }
+
+    gen_hashmap_bench_node_t* const node =
+            table->allocator.malloc(sizeof(gen_hashmap_bench_node_t));
+    if(!node) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate chaining node");
+    }
+
+    *node = (gen_hashmap_bench_node_t) {key, value, *bucket};
+    *bucket = node;
+
+    return GEN_NULL;
+}
+
+static gen_uint64_t* gen_hashmap_bench_internal_chaining_get(
+        const gen_hashmap_bench_chaining_t* const restrict table,
+        const gen_uint64_t key) {
+
+    gen_hashmap_bench_node_t* node =
+            *gen_hashmap_bench_internal_bucket(table, key);
+    for(; node; node = node->next) {
+        if(node->key == key) return &node->value;
+    }
+
+    return GEN_NULL;
+}
+
+static gen_bool_t gen_hashmap_bench_internal_chaining_remove(
+        gen_hashmap_bench_chaining_t* const restrict table,
+        const gen_uint64_t key) {
+
+    gen_hashmap_bench_node_t** link =
+            gen_hashmap_bench_internal_bucket(table, key);
+    for(; *link; link = &(*link)->next) {
+        gen_hashmap_bench_node_t* const node = *link;
+        if(node->key != key) continue;
+
+        *link = node->next;
+        table->allocator.free(node);
+
+        return gen_true;
+    }
+
+    return gen_false;
+}
+
+// Both tables are filled on the untimed first call and kept for the life of
+// the runner, so that only the operation under test is measured.
+static gen_hashmap_t gen_hashmap_bench_map = {0};
+static gen_hashmap_bench_chaining_t gen_hashmap_bench_chaining = {0};
+static gen_bool_t gen_hashmap_bench_filled = gen_false;
+
+// Churn keeps the tables at a constant size by inserting the key after the
+// newest and removing the oldest. Each table tracks its own position.
+static gen_size_t gen_hashmap_bench_map_oldest = 0;
+static gen_size_t gen_hashmap_bench_chaining_oldest = 0;
+
+static gen_error_t* gen_hashmap_bench_internal_fill(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(gen_hashmap_bench_filled) return GEN_NULL;
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    error = gen_hashmap_create(
+            &allocator, sizeof(gen_uint64_t), sizeof(gen_uint64_t),
+            GEN_HASHMAP_BENCH_ENTRIES, &gen_hashmap_bench_map);
+    if(error) return error;
+
+    gen_hashmap_bench_chaining.allocator = allocator;
+    gen_hashmap_bench_chaining.mask = GEN_HASHMAP_BENCH_ENTRIES - 1;
+    gen_hashmap_bench_chaining.buckets = allocator.calloc(
+            GEN_HASHMAP_BENCH_ENTRIES, sizeof(gen_hashmap_bench_node_t*));
+    if(!gen_hashmap_bench_chaining.buckets) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate chaining buckets");
+    }
+
+    for(gen_size_t i = 0; i < GEN_HASHMAP_BENCH_ENTRIES; ++i) {
+        const gen_uint64_t key = gen_hashmap_bench_internal_key(2 * i);
+
+        error = gen_hashmap_insert(&gen_hashmap_bench_map, &key, &i);
+        if(error) return error;
+
+        error = gen_hashmap_bench_internal_chaining_insert(
+                &gen_hashmap_bench_chaining, key, i);
+        if(error) return error;
+    }
+
+    gen_hashmap_bench_filled = gen_true;
+
+    return GEN_NULL;
+}
+
+// Lookups stride through the key space so that consecutive probes land far
+// apart, as they would for keys arriving from outside.
+#define GEN_HASHMAP_BENCH_STRIDE 40503
+
+static gen_error_t* gen_hashmap_bench_internal_lookup(
+        const gen_size_t iterations, const gen_size_t parity,
+        const gen_bool_t chaining) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_hashmap_bench_internal_fill();
+    if(error) return error;
+
+    const gen_size_t oldest = chaining ?
+            gen_hashmap_bench_chaining_oldest : gen_hashmap_bench_map_oldest;
+
+    gen_size_t found = 0;
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        const gen_size_t index =
+                oldest + (i * GEN_HASHMAP_BENCH_STRIDE) %
+                GEN_HASHMAP_BENCH_ENTRIES;
+        const gen_uint64_t key =
+                gen_hashmap_bench_internal_key(2 * index + parity);
+
+        if(chaining) {
+            found += !!gen_hashmap_bench_internal_chaining_get(
+                    &gen_hashmap_bench_chaining, key);
+        }
+        else {
+            void* value = GEN_NULL;
+            error = gen_hashmap_get(&gen_hashmap_bench_map, &key, &value);
+            if(error) return error;
+
+            found += !!value;
+        }
+    }
+
+    if(found != (parity ? 0 : iterations)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "Found %uz of %uz keys when looking up %t", found, iterations,
+                parity ? "misses" : "hits");
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_hashmap_bench_internal_churn(
+        const gen_size_t iterations, const gen_bool_t chaining) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_hashmap_bench_internal_fill();
+    if(error) return error;
+
+    gen_size_t* const oldest = chaining ?
+            &gen_hashmap_bench_chaining_oldest : &gen_hashmap_bench_map_oldest;
+
+    for(gen_size_t i = 0; i < iterations; ++i, ++*oldest) {
+        const gen_size_t newest = *oldest + GEN_HASHMAP_BENCH_ENTRIES;
+        const gen_uint64_t added = gen_hashmap_bench_internal_key(2 * newest);
+        const gen_uint64_t removed =
+                gen_hashmap_bench_internal_key(2 * *oldest);
+
+        gen_bool_t was_present = gen_false;
+        if(chaining) {
+            error = gen_hashmap_bench_internal_chaining_insert(
+                    &gen_hashmap_bench_chaining, added, newest);
+            if(error) return error;
+
+            was_present = gen_hashmap_bench_internal_chaining_remove(
+                    &gen_hashmap_bench_chaining, removed);
+        }
+        else {
+            error = gen_hashmap_insert(
+                    &gen_hashmap_bench_map, &added, &newest);
+            if(error) return error;
+
+            error = gen_hashmap_remove(
+                    &gen_hashmap_bench_map, &removed, &was_present);
+            if(error) return error;
+        }
+
+        if(!was_present) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                    "Churn lost track of key %uz", *oldest);
+        }
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(
+        gen_hashmap_bench_lookup_hit, "genhashmap-lookup-hit", 0) {
+
+    return gen_hashmap_bench_internal_lookup(iterations, 0, gen_false);
+}
+
+GEN_BENCH_DEFINE(
+        gen_hashmap_bench_lookup_miss, "genhashmap-lookup-miss", 0) {
+
+    return gen_hashmap_bench_internal_lookup(iterations, 1, gen_false);
+}
+
+GEN_BENCH_DEFINE(gen_hashmap_bench_churn, "genhashmap-churn", 0) {
+    return gen_hashmap_bench_internal_churn(iterations, gen_false);
+}
+
+GEN_BENCH_DEFINE(
+        gen_hashmap_bench_chaining_lookup_hit,
+        "genhashmap-chaining-lookup-hit", 0) {
+
+    return gen_hashmap_bench_internal_lookup(iterations, 0, gen_true);
+}
+
+GEN_BENCH_DEFINE(
+        gen_hashmap_bench_chaining_lookup_miss,
+        "genhashmap-chaining-lookup-miss", 0) {
+
+    return gen_hashmap_bench_internal_lookup(iterations, 1, gen_true);
+}
+
+GEN_BENCH_DEFINE(
+        gen_hashmap_bench_chaining_churn, "genhashmap-chaining-churn", 0) {
+
+    return gen_hashmap_bench_internal_churn(iterations, gen_true);
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_NAME "gencore"
+#include <genbench.h>
+
+#include <genio.h>
+#include <genlog.h>
+#include <genstream.h>
+
+// Messages are written to the null device so that the terminal and disk stay
+// out of the measurement.
+static gen_error_t* gen_log_bench_internal_run(
+        const gen_size_t iterations, const gen_uint64_t per_second) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    gen_file_t file = {0};
+    error = gen_file_open("/dev/null", GEN_FILE_ACCESS_WRITE, &file);
+    if(error) return error;
+
+    gen_stream_writer_t writer = {0};
+    error = gen_stream_writer_create(&allocator, &file, 0, &writer);
+    if(error) return error;
+
+    error = gen_log_set_target(&writer);
+    if(error) return error;
+
+    error = gen_log_set_rate_limit(per_second, per_second);
+    if(error) return error;
+
+    // Each message differs so that none are coalesced as repeats.
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        error = gen_log(
+                GEN_LOG_LEVEL_INFO, "genlogbench",
+                "Served request %uz from cache in %uz us", i, i % 512);
+        if(error) return error;
+    }
+
+    error = gen_log_set_rate_limit(0, 0);
+    if(error) return error;
+
+    error = gen_log_set_target(GEN_NULL);
+    if(error) return error;
+
+    error = gen_stream_writer_destroy(&writer);
+    if(error) return error;
+
+    return gen_file_close(&file);
+}
+
+GEN_BENCH_DEFINE(gen_log_bench_message, "genlog-message", 0) {
+    return gen_log_bench_internal_run(iterations, 0);
+}
+
+// A storm from one call site, where nearly every message is dropped before
+// being formatted.
+GEN_BENCH_DEFINE(gen_log_bench_suppressed, "genlog-suppressed", 0) {
+    return gen_log_bench_internal_run(iterations, 1);
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_BENCH_NAME "gencore"
+#include <genbench.h>
+
+#include <genformat.h>
+#include <genparse.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Numbers parsed per pass of a unit, and the longest text any of them has.
+#define GEN_PARSE_BENCH_COUNT 4096
+#define GEN_PARSE_BENCH_TEXT 64
+
+typedef struct {
+    char texts[GEN_PARSE_BENCH_COUNT][GEN_PARSE_BENCH_TEXT];
+    gen_size_t lengths[GEN_PARSE_BENCH_COUNT];
+} gen_parse_bench_fixture_t;
+
+static gen_parse_bench_fixture_t gen_parse_bench_integers = {0};
+static gen_parse_bench_fixture_t gen_parse_bench_doubles = {0};
+static gen_bool_t gen_parse_bench_ready = gen_false;
+
+static gen_uint64_t gen_parse_bench_internal_random(
+        gen_uint64_t* const restrict state) {
+
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+// Random bit patterns spread doubles evenly over exponents, rather than
+// clustering them around one magnitude as random fractions would.
+static double gen_parse_bench_internal_random_double(
+        gen_uint64_t* const restrict state) {
+
+    while(gen_true) {
+        const gen_uint64_t bits = gen_parse_bench_internal_random(state);
+        if(((bits >> 52) & 0x7FF) == 0x7FF) continue;
+
+        double value = 0.0;
+        __builtin_memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+}
+
+// Fixtures are built on the untimed first call.
+static gen_error_t* gen_parse_bench_internal_prepare(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(gen_parse_bench_ready) return GEN_NULL;
+
+    gen_uint64_t state = 0x9E3779B97F4A7C15ull;
+    for(gen_size_t i = 0; i < GEN_PARSE_BENCH_COUNT; ++i) {
+        const gen_uint64_t value = gen_parse_bench_internal_random(&state);
+
+        error = gen_format(
+                gen_parse_bench_integers.texts[i],
+                &gen_parse_bench_integers.lengths[i],
+                GEN_PARSE_BENCH_TEXT - 1, "%uz", value >> (value % 64));
+        if(error) return error;
+
+        const double number = gen_parse_bench_internal_random_double(&state);
+        const int length = snprintf(
+                gen_parse_bench_doubles.texts[i], GEN_PARSE_BENCH_TEXT,
+                "%.17g", number);
+        gen_parse_bench_doubles.lengths[i] = (gen_size_t) length;
+    }
+
+    gen_parse_bench_ready = gen_true;
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(gen_parse_bench_unsigned, "genparse-unsigned", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_parse_bench_internal_prepare();
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        const gen_size_t index = i % GEN_PARSE_BENCH_COUNT;
+
+        gen_uint64_t value = 0;
+        error = gen_parse_unsigned(
+                gen_parse_bench_integers.texts[index],
+                gen_parse_bench_integers.lengths[index], &value, GEN_NULL);
+        if(error) return error;
+
+        GEN_BENCH_KEEP(value);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(gen_parse_bench_strtoull, "genparse-strtoull", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_parse_bench_internal_prepare();
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        const gen_size_t index = i % GEN_PARSE_BENCH_COUNT;
+
+        const unsigned long long value = strtoull(
+                gen_parse_bench_integers.texts[index], GEN_NULL, 10);
+
+        GEN_BENCH_KEEP(value);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(gen_parse_bench_double, "genparse-double", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_parse_bench_internal_prepare();
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        const gen_size_t index = i % GEN_PARSE_BENCH_COUNT;
+
+        double value = 0.0;
+        error = gen_parse_double(
+                gen_parse_bench_doubles.texts[index],
+                gen_parse_bench_doubles.lengths[index], &value, GEN_NULL);
+        if(error) return error;
+
+        GEN_BENCH_KEEP(value);
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BENCH_DEFINE(gen_parse_bench_strtod, "genparse-strtod", 0) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_parse_bench_internal_prepare();
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < iterations; ++i) {
+        const gen_size_t index = i % GEN_PARSE_BENCH_COUNT;
+
+        const double value =
+                strtod(gen_parse_bench_doubles.texts[index], GEN_NULL);
+
+        GEN_BENCH_KEEP(value);
+    }
+
+    return GEN_NULL;
+}
@@ -2,9 +2,147 @@
 // Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
 
 #include "include/genallocator.h"
+#include "include/genmetrics.h"
 
 #include <genbackends.h>
 
+// Every allocation handed out by the system allocator is preceded by this
+// header so that frees can account for the bytes being released. `offset` is
+// the distance back to the start of the underlying allocation, which is
+// larger than the header itself for over-aligned allocations.
+typedef struct {
+    gen_size_t size;
+    gen_size_t offset;
+} gen_allocator_internal_header_t;
+
+#define GEN_ALLOCATOR_INTERNAL_HEADER_SIZE 16
+
+static gen_system_allocator_t gen_allocator_internal_backend = {0};
+
+static gen_allocator_statistics_t gen_allocator_internal_statistics = {0};
+
+static void gen_allocator_internal_track(const gen_size_t size) {
+    gen_allocator_statistics_t* const statistics =
+            &gen_allocator_internal_statistics;
+
+    __atomic_add_fetch(&statistics->allocations, 1, __ATOMIC_RELAXED);
+    const gen_size_t bytes =
+            __atomic_add_fetch(&statistics->bytes, size, __ATOMIC_RELAXED);
+
+    gen_size_t peak =
+            __atomic_load_n(&statistics->peak_bytes, __ATOMIC_RELAXED);
+    while(peak < bytes && !__atomic_compare_exchange_n(
+            &statistics->peak_bytes, &peak, bytes, gen_true,
+            __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    gen_metrics_internal_count_allocation(size);
+}
+
+static void gen_allocator_internal_untrack(const gen_size_t size) {
+    __atomic_sub_fetch(
+            &gen_allocator_internal_statistics.bytes, size, __ATOMIC_RELAXED);
+
+    gen_metrics_internal_count_free(size);
+}
+
+static void* gen_allocator_internal_finish(
+        gen_uint8_t* const restrict base, const gen_size_t offset,
+        const gen_size_t size) {
+
+    if(!base) return GEN_NULL;
+
+    gen_uint8_t* const allocation = base + offset;
+    gen_allocator_internal_header_t* const header =
+            (void*) (allocation - sizeof(gen_allocator_internal_header_t));
+    *header = (gen_allocator_internal_header_t) { size, offset };
+
+    gen_allocator_internal_track(size);
+
+    return allocation;
+}
+
+static gen_allocator_internal_header_t* gen_allocator_internal_get_header(
+        void* const restrict allocation) {
+
+    return (void*) ((gen_uint8_t*) allocation -
+                    sizeof(gen_allocator_internal_header_t));
+}
+
+static void* gen_allocator_internal_malloc(const gen_size_t size) {
+    if(size > GEN_SIZE_MAX - GEN_ALLOCATOR_INTERNAL_HEADER_SIZE) {
+        return GEN_NULL;
+    }
+
+    return gen_allocator_internal_finish(
+            gen_allocator_internal_backend.malloc(
+                    size + GEN_ALLOCATOR_INTERNAL_HEADER_SIZE),
+            GEN_ALLOCATOR_INTERNAL_HEADER_SIZE, size);
+}
+
+static void* gen_allocator_internal_calloc(
+        const gen_size_t count, const gen_size_t size) {
+
+    gen_size_t total = 0;
+    if(__builtin_mul_overflow(count, size, &total) ||
+       total > GEN_SIZE_MAX - GEN_ALLOCATOR_INTERNAL_HEADER_SIZE) {
+
+        return GEN_NULL;
+    }
+
+    return gen_allocator_internal_finish(
+            gen_allocator_internal_backend.calloc(
+                    1, total + GEN_ALLOCATOR_INTERNAL_HEADER_SIZE),
+            GEN_ALLOCATOR_INTERNAL_HEADER_SIZE, total);
+}
+
+static void* gen_allocator_internal_aligned_alloc(
+        const gen_size_t alignment, const gen_size_t size) {
+
+    // Keeps the allocation aligned while leaving room for the header.
+    const gen_size_t offset =
+            GEN_MAXIMUM(alignment, GEN_ALLOCATOR_INTERNAL_HEADER_SIZE);
+    if(size > GEN_SIZE_MAX - offset * 2) return GEN_NULL;
+
+    // `aligned_alloc` wants a size which is a multiple of the alignment.
+    const gen_size_t total = (size + offset * 2 - 1) & ~(offset - 1);
+
+    return gen_allocator_internal_finish(
+            gen_allocator_internal_backend.aligned_alloc(offset, total),
+            offset, size);
+}
+
+static void gen_allocator_internal_free(void* const restrict allocation) {
+    if(!allocation) return;
+
+    const gen_allocator_internal_header_t header =
+            *gen_allocator_internal_get_header(allocation);
+
+    gen_allocator_internal_untrack(header.size);
+
+    gen_allocator_internal_backend.free(
+            (gen_uint8_t*) allocation - header.offset);
+}
+
+static void* gen_allocator_internal_realloc(
+        void* const restrict allocation, const gen_size_t size) {
+
+    if(!allocation) return gen_allocator_internal_malloc(size);
+
+    const gen_allocator_internal_header_t header =
+            *gen_allocator_internal_get_header(allocation);
+    if(size > GEN_SIZE_MAX - header.offset) return GEN_NULL;
+
+    // Like the underlying `realloc`, the result is only guaranteed the
+    // fundamental alignment - the offset is a multiple of it so it is kept.
+    gen_uint8_t* const base = gen_allocator_internal_backend.realloc(
+            (gen_uint8_t*) allocation - header.offset, size + header.offset);
+    if(!base) return GEN_NULL;
+
+    gen_allocator_internal_untrack(header.size);
+
+    return gen_allocator_internal_finish(base, header.offset, size);
+}
+
 GEN_BACKENDS_PROC(get_system_allocator, gen_error_t*)
 gen_error_t* gen_get_system_allocator(
         gen_system_allocator_t* const restrict out_allocator) {
@@ -18,5 +156,67 @@ gen_error_t* gen_get_system_allocator(
                 "`out_allocator` was `GEN_NULL`");
     }
 
-    return gen_backends_get_system_allocator(out_allocator);
+    if(!gen_allocator_internal_backend.malloc) {
+        return gen_backends_get_system_allocator(out_allocator);
+    }
+
+    *out_allocator = (gen_system_allocator_t) {
+        gen_allocator_internal_malloc,
+        gen_allocator_internal_calloc,
+        gen_allocator_internal_aligned_alloc,
+        gen_allocator_internal_realloc,
+        gen_allocator_internal_free
+    };
+
+    return GEN_NULL;
+}
+
+GEN_INITIALIZER static void gen_allocator_internal_initialize(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // A failure here is reported again by `gen_get_system_allocator`.
+    error = gen_backends_get_system_allocator(&gen_allocator_internal_backend);
+    if(error) gen_allocator_internal_backend = (gen_system_allocator_t) {0};
+}
+
+gen_error_t* gen_allocator_get_statistics(
+        gen_allocator_statistics_t* const restrict out_statistics) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_statistics) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_statistics` was `GEN_NULL`");
+    }
+
+    gen_allocator_statistics_t* const statistics =
+            &gen_allocator_internal_statistics;
+
+    out_statistics->allocations =
+            __atomic_load_n(&statistics->allocations, __ATOMIC_RELAXED);
+    out_statistics->bytes =
+            __atomic_load_n(&statistics->bytes, __ATOMIC_RELAXED);
+    out_statistics->peak_bytes =
+            __atomic_load_n(&statistics->peak_bytes, __ATOMIC_RELAXED);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_allocator_reset_statistics(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_allocator_statistics_t* const statistics =
+            &gen_allocator_internal_statistics;
+
+    __atomic_store_n(&statistics->allocations, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(
+            &statistics->peak_bytes,
+            __atomic_load_n(&statistics->bytes, __ATOMIC_RELAXED),
+            __ATOMIC_RELAXED);
+
+    return GEN_NULL;
 }
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genasyncio.h"
+
+#include <genbackends.h>
+
+GEN_BACKENDS_PROC(async_io_queue_create, gen_error_t*)
+gen_error_t* gen_async_io_queue_create(
+        const gen_size_t depth,
+        gen_async_io_queue_t* const restrict out_queue) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!depth) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`depth` was 0");
+    }
+
+    if(!out_queue) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_queue` was `GEN_NULL`");
+    }
+
+    *out_queue = (gen_async_io_queue_t) {0};
+    out_queue->depth = depth;
+
+    return gen_backends_async_io_queue_create(depth, out_queue);
+}
+
+GEN_BACKENDS_PROC(async_io_queue_destroy, gen_error_t*)
+gen_error_t* gen_async_io_queue_destroy(
+        gen_async_io_queue_t* const restrict queue) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!queue) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`queue` was `GEN_NULL`");
+    }
+
+    if(queue->in_flight) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IN_USE, GEN_LINE_STRING,
+                "`queue` still had %uz requests in flight", queue->in_flight);
+    }
+
+    error = gen_backends_async_io_queue_destroy(queue);
+    if(error) return error;
+
+    *queue = (gen_async_io_queue_t) {0};
+
+    return GEN_NULL;
+}
+
+GEN_BACKENDS_PROC(async_io_register_buffers, gen_error_t*)
+gen_error_t* gen_async_io_register_buffers(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_buffer_t* const restrict buffers,
+        const gen_size_t count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!queue) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`queue` was `GEN_NULL`");
+    }
+
+    if(!buffers && count) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`buffers` was `GEN_NULL`");
+    }
+
+    if(queue->in_flight) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IN_USE, GEN_LINE_STRING,
+                "`queue` still had %uz requests in flight", queue->in_flight);
+    }
+
+    return gen_backends_async_io_register_buffers(queue, buffers, count);
+}
+
+GEN_BACKENDS_PROC(async_io_submit, gen_error_t*)
+gen_error_t* gen_async_io_submit(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_request_t* const restrict requests,
+        const gen_size_t count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!queue) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`queue` was `GEN_NULL`");
+    }
+
+    if(!requests) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`requests` was `GEN_NULL`");
+    }
+
+    if(count > queue->depth - queue->in_flight) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_SPACE, GEN_LINE_STRING,
+                "Submitting %uz requests would exceed the queue depth of %uz",
+                count, queue->depth);
+    }
+
+    for(gen_size_t i = 0; i < count; ++i) {
+        const gen_async_io_request_t* const request = &requests[i];
+
+        if(!request->file) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "`requests[%uz].file` was `GEN_NULL`", i);
+        }
+
+        if(request->operation == GEN_ASYNC_IO_OPERATION_SYNC) continue;
+
+        if(!request->buffer && request->size) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "`requests[%uz].buffer` was `GEN_NULL`", i);
+        }
+
+        if(request->size > GEN_UINT32_MAX) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                    "`requests[%uz].size` exceeded the maximum of %uz",
+                    i, (gen_size_t) GEN_UINT32_MAX);
+        }
+
+        const gen_file_access_t required =
+                request->operation == GEN_ASYNC_IO_OPERATION_READ ?
+                GEN_FILE_ACCESS_READ : GEN_FILE_ACCESS_WRITE;
+        if(!(request->file->access & required)) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                    "`requests[%uz].file` was not opened for the operation",
+                    i);
+        }
+    }
+
+    if(!count) return GEN_NULL;
+
+    gen_size_t submitted = 0;
+    error = gen_backends_async_io_submit(queue, requests, count, &submitted);
+    queue->in_flight += submitted;
+
+    return error;
+}
+
+GEN_BACKENDS_PROC(async_io_reap, gen_error_t*)
+gen_error_t* gen_async_io_reap(
+        gen_async_io_queue_t* const restrict queue,
+        gen_async_io_completion_t* const restrict out_completions,
+        const gen_size_t limit, const gen_size_t minimum,
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!queue) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`queue` was `GEN_NULL`");
+    }
+
+    if(!out_completions && limit) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_completions` was `GEN_NULL`");
+    }
+
+    if(minimum > limit) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`minimum` exceeded `limit`");
+    }
+
+    if(!out_count) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_count` was `GEN_NULL`");
+    }
+
+    *out_count = 0;
+    if(!limit || !queue->in_flight) return GEN_NULL;
+
+    error = gen_backends_async_io_reap(
+            queue, out_completions, GEN_MINIMUM(limit, queue->in_flight),
+            GEN_MINIMUM(minimum, queue->in_flight), out_count);
+    queue->in_flight -= *out_count;
+
+    return error;
+}
@@ -0,0 +1,592 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/gencompress.h"
+
+#define GEN_COMPRESS_INTERNAL_HASH_BITS 15
+#define GEN_COMPRESS_INTERNAL_HASH_MULTIPLIER 2654435761u
+#define GEN_COMPRESS_INTERNAL_HEADS (1 << GEN_COMPRESS_INTERNAL_HASH_BITS)
+
+// Offsets are stored in 16 bits, so matches reach back at most this far.
+#define GEN_COMPRESS_INTERNAL_WINDOW 65535
+#define GEN_COMPRESS_INTERNAL_CHAINS (GEN_COMPRESS_INTERNAL_WINDOW + 1)
+
+#define GEN_COMPRESS_INTERNAL_MINIMUM_MATCH 4
+#define GEN_COMPRESS_INTERNAL_RUN_MASK 15
+
+// The format has blocks end in at least 5 literals, with the last match
+// starting at least 12 bytes from the end, which lets decoders copy in wide
+// chunks for all but the tail of a block.
+#define GEN_COMPRESS_INTERNAL_LAST_LITERALS 5
+#define GEN_COMPRESS_INTERNAL_MATCH_LIMIT 12
+
+// The search skips ahead faster the longer it goes without a match, so that
+// incompressible data passes through quickly.
+#define GEN_COMPRESS_INTERNAL_SKIP_STRENGTH 6
+
+static GEN_FORCE_INLINE gen_uint32_t gen_compress_internal_read32(
+        const gen_uint8_t* const restrict p) {
+
+    gen_uint32_t x;
+    __builtin_memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+// Bytes of `p` which equal `match`, stopping at `limit`.
+static GEN_FORCE_INLINE gen_size_t gen_compress_internal_count(
+        const gen_uint8_t* p, const gen_uint8_t* match,
+        const gen_uint8_t* const limit) {
+
+    const gen_uint8_t* const start = p;
+
+    while(p + sizeof(gen_uint64_t) <= limit) {
+        gen_uint64_t a;
+        gen_uint64_t b;
+        __builtin_memcpy(&a, p, sizeof(a));
+        __builtin_memcpy(&b, match, sizeof(b));
+
+        const gen_uint64_t difference = a ^ b;
+        if(difference) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            const gen_size_t same = (gen_size_t) __builtin_clzll(difference);
+#else
+            const gen_size_t same = (gen_size_t) __builtin_ctzll(difference);
+#endif
+            return (gen_size_t) (p - start) + same / 8;
+        }
+
+        p += sizeof(gen_uint64_t);
+        match += sizeof(gen_uint64_t);
+    }
+
+    while(p < limit && *p == *match) {
+        ++p;
+        ++match;
+    }
+
+    return (gen_size_t) (p - start);
+}
+
+// Lengths which overflow their nibble of the token carry on in bytes of 255
+// until one is less.
+static GEN_FORCE_INLINE gen_uint8_t* gen_compress_internal_write_length(
+        gen_uint8_t* out, gen_size_t length) {
+
+    for(; length >= 255; length -= 255) *out++ = 255;
+    *out++ = (gen_uint8_t) length;
+
+    return out;
+}
+
+static GEN_FORCE_INLINE gen_size_t gen_compress_internal_length_size(
+        const gen_size_t length) {
+
+    if(length < GEN_COMPRESS_INTERNAL_RUN_MASK) return 0;
+    return (length - GEN_COMPRESS_INTERNAL_RUN_MASK) / 255 + 1;
+}
+
+static GEN_FORCE_INLINE void gen_compress_internal_insert(
+        gen_compressor_t* const restrict compressor,
+        const gen_uint32_t hash, const gen_uint32_t position) {
+
+    // A step of 0 ends the chain where the previous occurrence is too far
+    // back to use.
+    const gen_uint32_t distance = position - compressor->heads[hash];
+    compressor->chains[position & GEN_COMPRESS_INTERNAL_WINDOW] =
+            distance > GEN_COMPRESS_INTERNAL_WINDOW ?
+                    0 : (gen_uint16_t) distance;
+    compressor->heads[hash] = position;
+}
+
+static GEN_FORCE_INLINE gen_uint32_t gen_compress_internal_hash(
+        const gen_uint32_t sequence) {
+
+    return (sequence * GEN_COMPRESS_INTERNAL_HASH_MULTIPLIER) >>
+            (32 - GEN_COMPRESS_INTERNAL_HASH_BITS);
+}
+
+gen_error_t* gen_compressor_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_size_t depth,
+        gen_compressor_t* const restrict out_compressor) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!allocator) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`allocator` was `GEN_NULL`");
+    }
+
+    if(!out_compressor) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_compressor` was `GEN_NULL`");
+    }
+
+    *out_compressor = (gen_compressor_t) {0};
+
+    out_compressor->heads = allocator->calloc(
+            GEN_COMPRESS_INTERNAL_HEADS, sizeof(*out_compressor->heads));
+    if(!out_compressor->heads) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate compressor hash table");
+    }
+
+    out_compressor->chains = allocator->calloc(
+            GEN_COMPRESS_INTERNAL_CHAINS, sizeof(*out_compressor->chains));
+    if(!out_compressor->chains) {
+        allocator->free(out_compressor->heads);
+        out_compressor->heads = GEN_NULL;
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate compressor chain table");
+    }
+
+    out_compressor->allocator = *allocator;
+    out_compressor->depth = depth ? depth : GEN_COMPRESS_DEFAULT_DEPTH;
+
+    // Keeping positions at least a window in means the zeroed tables and any
+    // step back along a chain can never reach a valid position.
+    out_compressor->base = GEN_COMPRESS_INTERNAL_CHAINS;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_compressor_destroy(
+        gen_compressor_t* const restrict compressor) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!compressor) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`compressor` was `GEN_NULL`");
+    }
+
+    compressor->allocator.free(compressor->heads);
+    compressor->allocator.free(compressor->chains);
+
+    *compressor = (gen_compressor_t) {0};
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_compressor_compress(
+        gen_compressor_t* const restrict compressor,
+        const void* const restrict source, const gen_size_t size,
+        void* const restrict destination, const gen_size_t capacity,
+        gen_size_t* const restrict out_size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!compressor) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`compressor` was `GEN_NULL`");
+    }
+
+    if(!source && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`source` was `GEN_NULL`");
+    }
+
+    if(!destination) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`destination` was `GEN_NULL`");
+    }
+
+    if(!out_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_size` was `GEN_NULL`");
+    }
+
+    if(size > GEN_COMPRESS_MAXIMUM_SIZE) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "Block of %uz bytes exceeded the maximum of %uz", size,
+                GEN_COMPRESS_MAXIMUM_SIZE);
+    }
+
+    // The tables are only cleared once positions are about to overflow.
+    const gen_size_t position_limit =
+            GEN_UINT32_MAX - GEN_COMPRESS_INTERNAL_CHAINS - size;
+    if(compressor->base > position_limit) {
+        __builtin_memset(
+                compressor->heads, 0,
+                GEN_COMPRESS_INTERNAL_HEADS * sizeof(*compressor->heads));
+        __builtin_memset(
+                compressor->chains, 0,
+                GEN_COMPRESS_INTERNAL_CHAINS * sizeof(*compressor->chains));
+        compressor->base = GEN_COMPRESS_INTERNAL_CHAINS;
+    }
+
+    // Everything from earlier blocks falls below `base` and is out of reach.
+    const gen_uint32_t base = compressor->base;
+    compressor->base += (gen_uint32_t) size;
+
+    const gen_uint8_t* const start = source;
+    const gen_uint8_t* const end = start + size;
+    gen_uint8_t* out = destination;
+    gen_uint8_t* const out_end = out + capacity;
+
+    const gen_uint8_t* anchor = start;
+
+    if(size > GEN_COMPRESS_INTERNAL_MATCH_LIMIT) {
+        const gen_uint8_t* const match_limit =
+                end - GEN_COMPRESS_INTERNAL_MATCH_LIMIT;
+        const gen_uint8_t* const extend_limit =
+                end - GEN_COMPRESS_INTERNAL_LAST_LITERALS;
+
+        const gen_size_t initial_misses =
+                1 << GEN_COMPRESS_INTERNAL_SKIP_STRENGTH;
+        gen_size_t misses = initial_misses;
+
+        const gen_uint8_t* p = start;
+        while(p <= match_limit) {
+            const gen_uint32_t sequence = gen_compress_internal_read32(p);
+            const gen_uint32_t hash = gen_compress_internal_hash(sequence);
+            const gen_uint32_t position = base + (gen_uint32_t) (p - start);
+
+            gen_uint32_t candidate = compressor->heads[hash];
+            gen_compress_internal_insert(compressor, hash, position);
+
+            const gen_uint8_t* match = GEN_NULL;
+            gen_size_t length = 0;
+
+            // Earlier occurrences of the hash are tried from the nearest out,
+            // keeping the longest match.
+            for(gen_size_t i = 0; i < compressor->depth; ++i) {
+                if(candidate < base) break;
+                if(position - candidate > GEN_COMPRESS_INTERNAL_WINDOW) break;
+
+                const gen_uint8_t* const found = start + (candidate - base);
+                if(gen_compress_internal_read32(found) == sequence) {
+                    const gen_size_t found_length =
+                            GEN_COMPRESS_INTERNAL_MINIMUM_MATCH +
+                            gen_compress_internal_count(
+                                    p + GEN_COMPRESS_INTERNAL_MINIMUM_MATCH,
+                                    found + GEN_COMPRESS_INTERNAL_MINIMUM_MATCH,
+                                    extend_limit);
+
+                    if(found_length > length) {
+                        match = found;
+                        length = found_length;
+
+                        if(p + length == extend_limit) break;
+                    }
+                }
+
+                const gen_uint16_t step = compressor->chains[
+                        candidate & GEN_COMPRESS_INTERNAL_WINDOW];
+                if(!step) break;
+
+                candidate -= step;
+            }
+
+            if(!match) {
+                p += misses++ >> GEN_COMPRESS_INTERNAL_SKIP_STRENGTH;
+                continue;
+            }
+
+            // The bytes just before both may match as well.
+            while(p > anchor && match > start && p[-1] == match[-1]) {
+                --p;
+                --match;
+                ++length;
+            }
+
+            const gen_size_t literals = (gen_size_t) (p - anchor);
+            const gen_size_t offset = (gen_size_t) (p - match);
+            const gen_size_t extra =
+                    length - GEN_COMPRESS_INTERNAL_MINIMUM_MATCH;
+
+            const gen_size_t needed =
+                    1 + gen_compress_internal_length_size(literals) +
+                    literals + 2 + gen_compress_internal_length_size(extra);
+            if(needed > (gen_size_t) (out_end - out)) {
+                return gen_error_attach_backtrace(
+                        GEN_ERROR_TOO_SHORT, GEN_LINE_STRING,
+                        "Compressed block exceeded `capacity` %uz", capacity);
+            }
+
+            gen_uint8_t* const token = out++;
+            *token = (gen_uint8_t) (
+                    GEN_MINIMUM(literals, GEN_COMPRESS_INTERNAL_RUN_MASK) << 4 |
+                    GEN_MINIMUM(extra, GEN_COMPRESS_INTERNAL_RUN_MASK));
+
+            if(literals >= GEN_COMPRESS_INTERNAL_RUN_MASK) {
+                out = gen_compress_internal_write_length(
+                        out, literals - GEN_COMPRESS_INTERNAL_RUN_MASK);
+            }
+
+            // Literals ahead of a match are at least `MATCH_LIMIT` bytes from
+            // the end of the source, so they can be copied a word at a time
+            // where the destination has room to spare.
+            const gen_size_t word = sizeof(gen_uint64_t);
+            if((gen_size_t) (out_end - out) >= literals + word) {
+                for(gen_size_t i = 0; i < literals; i += word) {
+                    __builtin_memcpy(out + i, anchor + i, word);
+                }
+            }
+            else __builtin_memcpy(out, anchor, literals);
+            out += literals;
+
+            *out++ = (gen_uint8_t) (offset & 0xFF);
+            *out++ = (gen_uint8_t) (offset >> 8);
+
+            if(extra >= GEN_COMPRESS_INTERNAL_RUN_MASK) {
+                out = gen_compress_internal_write_length(
+                        out, extra - GEN_COMPRESS_INTERNAL_RUN_MASK);
+            }
+
+            p += length;
+            anchor = p;
+            misses = initial_misses;
+
+            if(p > match_limit) break;
+
+            // Seeds the tables from within the match, which is skipped over.
+            const gen_uint8_t* const seed = p - 2;
+            gen_compress_internal_insert(
+                    compressor,
+                    gen_compress_internal_hash(
+                            gen_compress_internal_read32(seed)),
+                    base + (gen_uint32_t) (seed - start));
+        }
+    }
+
+    const gen_size_t literals = (gen_size_t) (end - anchor);
+    const gen_size_t needed =
+            1 + gen_compress_internal_length_size(literals) + literals;
+    if(needed > (gen_size_t) (out_end - out)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_SHORT, GEN_LINE_STRING,
+                "Compressed block exceeded `capacity` %uz", capacity);
+    }
+
+    *out++ = (gen_uint8_t) (
+            GEN_MINIMUM(literals, GEN_COMPRESS_INTERNAL_RUN_MASK) << 4);
+    if(literals >= GEN_COMPRESS_INTERNAL_RUN_MASK) {
+        out = gen_compress_internal_write_length(
+                out, literals - GEN_COMPRESS_INTERNAL_RUN_MASK);
+    }
+
+    if(literals) __builtin_memcpy(out, anchor, literals);
+    out += literals;
+
+    *out_size = (gen_size_t) (out - (gen_uint8_t*) destination);
+
+    return GEN_NULL;
+}
+
+// Wide copies may write up to this far past the end of what they copy.
+#define GEN_COMPRESS_INTERNAL_WILD_COPY 16
+
+// What the decoder's fast path needs to be left in each buffer: up to 14
+// literals copied as 16 followed by an offset, and up to 14 literals plus
+// up to 18 bytes of match copied as 24.
+#define GEN_COMPRESS_INTERNAL_FAST_INPUT 16
+#define GEN_COMPRESS_INTERNAL_FAST_OUTPUT 40
+
+gen_error_t* gen_decompress(
+        const void* const restrict source, const gen_size_t size,
+        void* const restrict destination, const gen_size_t capacity,
+        gen_size_t* const restrict out_size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!source) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`source` was `GEN_NULL`");
+    }
+
+    if(!destination && capacity) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`destination` was `GEN_NULL`");
+    }
+
+    if(!out_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_size` was `GEN_NULL`");
+    }
+
+    const gen_uint8_t* in = source;
+    const gen_uint8_t* const in_end = in + size;
+    gen_uint8_t* const out_start = destination;
+    gen_uint8_t* out = out_start;
+    gen_uint8_t* const out_end = out + capacity;
+
+    while(gen_true) {
+        if(in == in_end) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "Block ended partway through a sequence");
+        }
+
+        const gen_size_t token = *in++;
+
+        // Most sequences have short literals and a short match at least a
+        // word back. With room to spare in both buffers these are checked up
+        // front and copied with fixed-size copies.
+        if(token >> 4 < GEN_COMPRESS_INTERNAL_RUN_MASK &&
+           (token & GEN_COMPRESS_INTERNAL_RUN_MASK) <
+                   GEN_COMPRESS_INTERNAL_RUN_MASK &&
+           in_end - in >= GEN_COMPRESS_INTERNAL_FAST_INPUT &&
+           out_end - out >= GEN_COMPRESS_INTERNAL_FAST_OUTPUT) {
+
+            const gen_size_t literals = token >> 4;
+            const gen_size_t offset = (gen_size_t) in[literals] |
+                    (gen_size_t) in[literals + 1] << 8;
+            const gen_size_t produced = (gen_size_t) (out - out_start);
+
+            if(offset >= sizeof(gen_uint64_t) &&
+               offset <= produced + literals) {
+
+                __builtin_memcpy(out, in, GEN_COMPRESS_INTERNAL_WILD_COPY);
+                in += literals + 2;
+                out += literals;
+
+                const gen_uint8_t* const match = out - offset;
+                __builtin_memcpy(out, match, sizeof(gen_uint64_t));
+                __builtin_memcpy(out + 8, match + 8, sizeof(gen_uint64_t));
+                __builtin_memcpy(out + 16, match + 16, sizeof(gen_uint64_t));
+                out += (token & GEN_COMPRESS_INTERNAL_RUN_MASK) +
+                        GEN_COMPRESS_INTERNAL_MINIMUM_MATCH;
+
+                continue;
+            }
+        }
+
+        gen_size_t literals = token >> 4;
+        if(literals == GEN_COMPRESS_INTERNAL_RUN_MASK) {
+            gen_uint8_t byte = 255;
+            while(byte == 255) {
+                if(in == in_end) {
+                    return gen_error_attach_backtrace(
+                            GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                            "Block ended partway through a length");
+                }
+
+                byte = *in++;
+                literals += byte;
+            }
+        }
+
+        const gen_size_t in_left = (gen_size_t) (in_end - in);
+        const gen_size_t out_left = (gen_size_t) (out_end - out);
+        if(literals > in_left || literals > out_left) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "%uz literals overran the block or `capacity` %uz",
+                    literals, capacity);
+        }
+
+        if(in_left - literals >= GEN_COMPRESS_INTERNAL_WILD_COPY &&
+           out_left - literals >= GEN_COMPRESS_INTERNAL_WILD_COPY) {
+
+            for(gen_size_t i = 0; i < literals;
+                    i += GEN_COMPRESS_INTERNAL_WILD_COPY) {
+
+                __builtin_memcpy(
+                        out + i, in + i, GEN_COMPRESS_INTERNAL_WILD_COPY);
+            }
+        }
+        else __builtin_memcpy(out, in, literals);
+
+        in += literals;
+        out += literals;
+
+        // Only the last sequence ends without a match.
+        if(in == in_end) break;
+
+        if(in_end - in < 2) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "Block ended partway through an offset");
+        }
+
+        const gen_size_t offset = (gen_size_t) in[0] | (gen_size_t) in[1] << 8;
+        in += 2;
+
+        if(!offset || offset > (gen_size_t) (out - out_start)) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "Match offset %uz was outside the %uz bytes decompressed",
+                    offset, (gen_size_t) (out - out_start));
+        }
+
+        gen_size_t length = token & GEN_COMPRESS_INTERNAL_RUN_MASK;
+        if(length == GEN_COMPRESS_INTERNAL_RUN_MASK) {
+            gen_uint8_t byte = 255;
+            while(byte == 255) {
+                if(in == in_end) {
+                    return gen_error_attach_backtrace(
+                            GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                            "Block ended partway through a length");
+                }
+
+                byte = *in++;
+                length += byte;
+            }
+        }
+        length += GEN_COMPRESS_INTERNAL_MINIMUM_MATCH;
+
+        if(length > (gen_size_t) (out_end - out)) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "Match of %uz bytes overran `capacity` %uz", length,
+                    capacity);
+        }
+
+        const gen_uint8_t* const match = out - offset;
+        gen_uint8_t* const match_end = out + length;
+
+        const gen_size_t room = (gen_size_t) (out_end - out);
+        const gen_size_t wide = GEN_COMPRESS_INTERNAL_WILD_COPY;
+        const gen_size_t word = sizeof(gen_uint64_t);
+
+        // A match at least a chunk back never reads bytes the same chunk
+        // writes, so it can be copied in wide chunks like literals.
+        if(offset >= wide && room >= length + wide) {
+            for(gen_size_t i = 0; i < length; i += wide) {
+                __builtin_memcpy(out + i, match + i, wide);
+            }
+        }
+        else if(offset >= word && room >= length + word) {
+            for(gen_size_t i = 0; i < length; i += word) {
+                __builtin_memcpy(out + i, match + i, word);
+            }
+        }
+        else {
+            // Short offsets repeat a pattern, which is copied from its start
+            // in runs that double in length as more of it is written out.
+            gen_uint8_t* to = out;
+            while(to < match_end) {
+                const gen_size_t run = GEN_MINIMUM(
+                        (gen_size_t) (to - match),
+                        (gen_size_t) (match_end - to));
+                __builtin_memcpy(to, match, run);
+                to += run;
+            }
+        }
+
+        out = match_end;
+    }
+
+    *out_size = (gen_size_t) (out - out_start);
+
+    return GEN_NULL;
+}
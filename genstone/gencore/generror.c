@@ -3,11 +3,61 @@
 
 #include "include/gencommon.h"
 #include "include/genformat.h"
+#include "include/genmetrics.h"
+#include "include/genrecorder.h"
+#include "include/genstringbuilder.h"
 
 #include <genbackends.h>
 
 static GEN_THREAD_LOCAL gen_error_t error_buffer = {0};
 
+// Thread locals can only be initialized statically, so the allocator is
+// fetched on first use and contexts stay inline until then.
+static GEN_THREAD_LOCAL gen_string_builder_t error_context = {
+    .capacity = GEN_STRING_BUILDER_INLINE_CAPACITY
+};
+static GEN_THREAD_LOCAL gen_bool_t error_context_allocator_fetched = gen_false;
+
+GEN_BACKENDS_PROC(error_watch_thread, void)
+
+// Errors raised while fetching the allocator must not try again.
+static void gen_error_internal_fetch_allocator(void) {
+    if(error_context_allocator_fetched) return;
+    error_context_allocator_fetched = gen_true;
+
+    // Contexts can only reach the heap once there is an allocator, so this is
+    // the first point at which the thread needs watching.
+    gen_backends_error_watch_thread();
+
+    gen_system_allocator_t allocator = {0};
+    if(!gen_get_system_allocator(&allocator)) {
+        error_context.allocator = allocator;
+    }
+}
+
+// Every raised error passes through here, so the record is assembled by
+// copying rather than going through the formatter.
+static void gen_error_internal_record(
+        const gen_error_t* const restrict raised) {
+
+    // GEN_ERROR_BLAH at line 43: I died!
+    const char* const parts[] = {
+        gen_error_type_name(raised->type), " at line ", raised->line, ": ",
+        raised->context
+    };
+
+    char record[GEN_RECORDER_RECORD_LENGTH];
+    gen_size_t length = 0;
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(parts); ++i) {
+        for(gen_size_t j = 0; parts[i][j]; ++j) {
+            if(length == sizeof(record)) break;
+            record[length++] = parts[i][j];
+        }
+    }
+
+    gen_recorder_record(record, length);
+}
+
 gen_error_t* gen_error_attach_backtrace(
         const gen_error_type_t type, const char* const restrict line,
         const char* const restrict format, ...) {
@@ -18,19 +68,36 @@ gen_error_t* gen_error_attach_backtrace(
     retval->type = type;
     retval->line = line;
 
+    gen_metrics_internal_count_error(type);
+
     gen_tooling_get_backtrace(retval->backtrace, &retval->backtrace_length);
 
 	gen_variadic_list_t list;
 	gen_variadic_list_start(list, format);
 
-    if(gen_format_variadic_list(
-            retval->context, GEN_NULL, GEN_ERROR_MAXIMUM_CONTEXT_LENGTH,
-            format, list)) gen_abort();
+    gen_error_internal_fetch_allocator();
+
+    // A context cut short by a failed allocation is still worth reporting.
+    error_context.length = 0;
+    gen_bool_t exhausted = gen_false;
+    if(gen_format_internal_builder_variadic_list(
+            &error_context, format, list, &exhausted)) gen_abort();
+
+    retval->context = gen_string_builder_internal_data(&error_context);
+
+    // Errors are recorded as they are raised since many are handled without
+    // ever being logged.
+    gen_error_internal_record(retval);
 
 	return retval;
 }
 
+void gen_error_internal_release_context(void) {
+    gen_string_builder_destroy(&error_context);
+}
+
 GEN_BACKENDS_PROC(abort, GEN_NORETURN void)
 void gen_abort(void) {
+    gen_recorder_dump();
     gen_backends_abort();
 }
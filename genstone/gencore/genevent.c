@@ -0,0 +1,542 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genevent.h"
+#include "include/gentime.h"
+
+#include <genbackends.h>
+
+#define GEN_EVENT_TIMER_WHEEL_MASK (GEN_EVENT_TIMER_WHEEL_SLOTS - 1)
+
+static GEN_FORCE_INLINE gen_size_t gen_event_timer_wheel_internal_index(
+        const gen_uint64_t time, const gen_size_t level) {
+
+    return (time >> (level * GEN_EVENT_TIMER_WHEEL_SLOT_BITS)) &
+            GEN_EVENT_TIMER_WHEEL_MASK;
+}
+
+static void gen_event_timer_wheel_internal_place(
+        gen_event_timer_wheel_t* const restrict wheel,
+        gen_event_timer_t* const restrict timer) {
+
+    // The level is chosen by the highest bit in which the deadline differs
+    // from the current time, so a timer only ever waits in a slot ahead of
+    // the one the current time is in.
+    const gen_uint64_t difference = timer->deadline ^ wheel->now;
+    gen_size_t level =
+            (63 - GEN_LEADING_ZEROES(difference)) /
+            GEN_EVENT_TIMER_WHEEL_SLOT_BITS;
+    gen_size_t slot;
+
+    // Deadlines beyond the top level's span wait in its furthest slot and are
+    // placed again once it comes around.
+    if(level >= GEN_EVENT_TIMER_WHEEL_LEVELS) {
+        level = GEN_EVENT_TIMER_WHEEL_LEVELS - 1;
+
+        const gen_size_t shift = level * GEN_EVENT_TIMER_WHEEL_SLOT_BITS;
+        const gen_uint64_t span =
+                (timer->deadline >> shift) - (wheel->now >> shift);
+
+        slot = span < GEN_EVENT_TIMER_WHEEL_SLOTS ?
+                gen_event_timer_wheel_internal_index(timer->deadline, level) :
+                (gen_event_timer_wheel_internal_index(wheel->now, level) - 1) &
+                GEN_EVENT_TIMER_WHEEL_MASK;
+    }
+    else slot = gen_event_timer_wheel_internal_index(timer->deadline, level);
+
+    gen_event_timer_t** const head = &wheel->slots[level][slot];
+
+    timer->armed = gen_true;
+    timer->level = level;
+    timer->slot = slot;
+    timer->previous = GEN_NULL;
+    timer->next = *head;
+    if(*head) (*head)->previous = timer;
+    *head = timer;
+
+    wheel->occupied[level] |= 1ull << slot;
+}
+
+static void gen_event_timer_wheel_internal_unlink(
+        gen_event_timer_wheel_t* const restrict wheel,
+        gen_event_timer_t* const restrict timer) {
+
+    gen_event_timer_t** const head = &wheel->slots[timer->level][timer->slot];
+
+    if(timer->previous) timer->previous->next = timer->next;
+    else *head = timer->next;
+    if(timer->next) timer->next->previous = timer->previous;
+
+    if(!*head) wheel->occupied[timer->level] &= ~(1ull << timer->slot);
+
+    timer->armed = gen_false;
+    timer->next = GEN_NULL;
+    timer->previous = GEN_NULL;
+}
+
+// Finds the start of the earliest occupied slot across all levels.
+static gen_uint64_t gen_event_timer_wheel_internal_next(
+        const gen_event_timer_wheel_t* const restrict wheel) {
+
+    gen_uint64_t next = GEN_UINT64_MAX;
+
+    for(gen_size_t i = 0; i < GEN_EVENT_TIMER_WHEEL_LEVELS; ++i) {
+        const gen_uint64_t occupied = wheel->occupied[i];
+        if(!occupied) continue;
+
+        const gen_size_t shift = i * GEN_EVENT_TIMER_WHEEL_SLOT_BITS;
+        const gen_size_t index =
+                gen_event_timer_wheel_internal_index(wheel->now, i);
+
+        const gen_uint64_t rotated =
+                index ? (occupied >> index) | (occupied << (64 - index)) :
+                occupied;
+        const gen_uint64_t distance =
+                (gen_uint64_t) __builtin_ctzll(rotated);
+
+        gen_uint64_t start = ((wheel->now >> shift) + distance) << shift;
+        if(start < wheel->now) start = wheel->now;
+
+        next = GEN_MINIMUM(next, start);
+    }
+
+    return next;
+}
+
+gen_error_t* gen_event_timer_wheel_create(
+        const gen_uint64_t now,
+        gen_event_timer_wheel_t* const restrict out_wheel) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_wheel) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_wheel` was `GEN_NULL`");
+    }
+
+    *out_wheel = (gen_event_timer_wheel_t) {0};
+    out_wheel->now = now;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_event_timer_wheel_add(
+        gen_event_timer_wheel_t* const restrict wheel,
+        gen_event_timer_t* const restrict timer, const gen_uint64_t deadline) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!wheel) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`wheel` was `GEN_NULL`");
+    }
+
+    if(!timer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`timer` was `GEN_NULL`");
+    }
+
+    if(!timer->handler) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`timer->handler` was `GEN_NULL`");
+    }
+
+    if(timer->armed) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_IN_USE, GEN_LINE_STRING,
+                "`timer` was already armed");
+    }
+
+    // Nothing may wait in the current slot as it is the one being drained, so
+    // overdue timers are pushed to the next tick.
+    timer->deadline = deadline > wheel->now ? deadline : wheel->now + 1;
+
+    gen_event_timer_wheel_internal_place(wheel, timer);
+    ++wheel->count;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_event_timer_wheel_cancel(
+        gen_event_timer_wheel_t* const restrict wheel,
+        gen_event_timer_t* const restrict timer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!wheel) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`wheel` was `GEN_NULL`");
+    }
+
+    if(!timer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`timer` was `GEN_NULL`");
+    }
+
+    if(!timer->armed) return GEN_NULL;
+
+    gen_event_timer_wheel_internal_unlink(wheel, timer);
+    --wheel->count;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_event_timer_wheel_get_timeout(
+        const gen_event_timer_wheel_t* const restrict wheel,
+        gen_uint64_t* const restrict out_timeout) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!wheel) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`wheel` was `GEN_NULL`");
+    }
+
+    if(!out_timeout) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_timeout` was `GEN_NULL`");
+    }
+
+    if(!wheel->count) {
+        *out_timeout = GEN_EVENT_LOOP_INFINITE;
+        return GEN_NULL;
+    }
+
+    *out_timeout = gen_event_timer_wheel_internal_next(wheel) - wheel->now;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_event_timer_wheel_advance(
+        gen_event_timer_wheel_t* const restrict wheel, const gen_uint64_t now,
+        gen_event_loop_t* const restrict loop) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!wheel) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`wheel` was `GEN_NULL`");
+    }
+
+    while(wheel->count) {
+        const gen_uint64_t next = gen_event_timer_wheel_internal_next(wheel);
+        if(next > now) break;
+
+        wheel->now = next;
+
+        // Higher levels are drained first so that timers cascading down into
+        // the current time are fired within this pass.
+        for(gen_size_t i = GEN_EVENT_TIMER_WHEEL_LEVELS; i--;) {
+            const gen_size_t index =
+                    gen_event_timer_wheel_internal_index(wheel->now, i);
+
+            gen_event_timer_t* timer;
+            while((timer = wheel->slots[i][index])) {
+                gen_event_timer_wheel_internal_unlink(wheel, timer);
+
+                if(timer->deadline > wheel->now) {
+                    gen_event_timer_wheel_internal_place(wheel, timer);
+                    continue;
+                }
+
+                --wheel->count;
+
+                error = timer->handler(loop, timer, timer->user_data);
+                if(error) return error;
+            }
+        }
+    }
+
+    if(now > wheel->now) wheel->now = now;
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_event_loop_internal_get_time(
+        gen_uint64_t* const restrict out_time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_time_get_monotonic(out_time);
+    if(error) return error;
+
+    *out_time /= GEN_TIME_NANOSECONDS_PER_SECOND / 1000;
+
+    return GEN_NULL;
+}
+
+GEN_BACKENDS_PROC(event_loop_create, gen_error_t*)
+gen_error_t* gen_event_loop_create(gen_event_loop_t* const restrict out_loop) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_loop` was `GEN_NULL`");
+    }
+
+    *out_loop = (gen_event_loop_t) {0};
+
+    gen_uint64_t now = 0;
+    error = gen_event_loop_internal_get_time(&now);
+    if(error) return error;
+
+    error = gen_event_timer_wheel_create(now, &out_loop->timers);
+    if(error) return error;
+
+    return gen_backends_event_loop_create(out_loop);
+}
+
+GEN_BACKENDS_PROC(event_loop_destroy, gen_error_t*)
+gen_error_t* gen_event_loop_destroy(gen_event_loop_t* const restrict loop) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    error = gen_backends_event_loop_destroy(loop);
+    if(error) return error;
+
+    *loop = (gen_event_loop_t) {0};
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_event_loop_internal_validate_source(
+        const gen_event_loop_t* const restrict loop,
+        const gen_event_source_t* const restrict source) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    if(!source) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`source` was `GEN_NULL`");
+    }
+
+    if(!source->handler) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`source->handler` was `GEN_NULL`");
+    }
+
+    return GEN_NULL;
+}
+
+GEN_BACKENDS_PROC(event_loop_add, gen_error_t*)
+gen_error_t* gen_event_loop_add(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_event_loop_internal_validate_source(loop, source);
+    if(error) return error;
+
+    return gen_backends_event_loop_add(loop, source);
+}
+
+GEN_BACKENDS_PROC(event_loop_modify, gen_error_t*)
+gen_error_t* gen_event_loop_modify(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_event_loop_internal_validate_source(loop, source);
+    if(error) return error;
+
+    return gen_backends_event_loop_modify(loop, source);
+}
+
+GEN_BACKENDS_PROC(event_loop_remove, gen_error_t*)
+gen_error_t* gen_event_loop_remove(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_event_loop_internal_validate_source(loop, source);
+    if(error) return error;
+
+    error = gen_backends_event_loop_remove(loop, source);
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < loop->ready_count; ++i) {
+        if(loop->ready[i].source == source) loop->ready[i].source = GEN_NULL;
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_event_loop_add_timer(
+        gen_event_loop_t* const restrict loop,
+        gen_event_timer_t* const restrict timer, const gen_uint64_t delay) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    gen_uint64_t now = 0;
+    error = gen_event_loop_internal_get_time(&now);
+    if(error) return error;
+
+    const gen_uint64_t deadline =
+            delay > GEN_UINT64_MAX - now ? GEN_UINT64_MAX : now + delay;
+
+    return gen_event_timer_wheel_add(&loop->timers, timer, deadline);
+}
+
+gen_error_t* gen_event_loop_cancel_timer(
+        gen_event_loop_t* const restrict loop,
+        gen_event_timer_t* const restrict timer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    return gen_event_timer_wheel_cancel(&loop->timers, timer);
+}
+
+GEN_BACKENDS_PROC(event_loop_wake, gen_error_t*)
+gen_error_t* gen_event_loop_wake(gen_event_loop_t* const restrict loop) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    return gen_backends_event_loop_wake(loop);
+}
+
+GEN_BACKENDS_PROC(event_loop_wait, gen_error_t*)
+gen_error_t* gen_event_loop_run_once(
+        gen_event_loop_t* const restrict loop, const gen_uint64_t timeout) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    gen_uint64_t now = 0;
+    error = gen_event_loop_internal_get_time(&now);
+    if(error) return error;
+
+    gen_uint64_t wait = 0;
+    error = gen_event_timer_wheel_get_timeout(&loop->timers, &wait);
+    if(error) return error;
+
+    // The wheel only moves forward when advanced so account for time which
+    // has passed since.
+    if(wait != GEN_EVENT_LOOP_INFINITE) {
+        const gen_uint64_t elapsed = now - loop->timers.now;
+        wait = wait > elapsed ? wait - elapsed : 0;
+    }
+    wait = GEN_MINIMUM(wait, timeout);
+
+    loop->ready_count = 0;
+    error = gen_backends_event_loop_wait(
+            loop, wait, loop->ready, GEN_EVENT_LOOP_MAXIMUM_READY,
+            &loop->ready_count);
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < loop->ready_count; ++i) {
+        gen_event_source_t* const source = loop->ready[i].source;
+        if(!source) continue;
+
+        error = source->handler(
+                loop, source, loop->ready[i].readiness, source->user_data);
+        if(error) {
+            loop->ready_count = 0;
+            return error;
+        }
+    }
+    loop->ready_count = 0;
+
+    error = gen_event_loop_internal_get_time(&now);
+    if(error) return error;
+
+    return gen_event_timer_wheel_advance(&loop->timers, now, loop);
+}
+
+gen_error_t* gen_event_loop_run(gen_event_loop_t* const restrict loop) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    while(!__atomic_load_n(&loop->stopping, __ATOMIC_ACQUIRE)) {
+        error = gen_event_loop_run_once(loop, GEN_EVENT_LOOP_INFINITE);
+        if(error) return error;
+    }
+
+    __atomic_store_n(&loop->stopping, gen_false, __ATOMIC_RELAXED);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_event_loop_stop(gen_event_loop_t* const restrict loop) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!loop) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`loop` was `GEN_NULL`");
+    }
+
+    __atomic_store_n(&loop->stopping, gen_true, __ATOMIC_RELEASE);
+
+    return gen_backends_event_loop_wake(loop);
+}
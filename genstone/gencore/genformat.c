@@ -2,6 +2,7 @@
 // Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
 
 #include "include/genformat.h"
+#include "include/genstringbuilder.h"
 
 gen_error_t* gen_format(
         char* const restrict out_buffer, gen_size_t* const restrict out_len,
@@ -16,12 +17,43 @@ gen_error_t* gen_format(
     return gen_format_variadic_list(out_buffer, out_len, limit, format, list);
 }
 
+typedef struct {
+    char* buffer;
+    gen_size_t limit;
+    gen_size_t position;
+
+    // Output past `limit` grows the builder rather than being dropped, until
+    // growing fails and the builder is let go of.
+    gen_string_builder_t* builder;
+    gen_size_t base;
+} gen_format_internal_sink_t;
+
+static void gen_format_internal_put(
+        gen_format_internal_sink_t* const restrict sink, const char c) {
+
+    if(sink->position >= sink->limit && sink->builder) {
+        gen_string_builder_t* const builder = sink->builder;
+        const gen_size_t capacity = sink->base + sink->position + 1;
+
+        if(gen_string_builder_internal_grow(builder, capacity)) {
+            sink->buffer =
+                    gen_string_builder_internal_data(builder) + sink->base;
+            sink->limit = builder->capacity - sink->base;
+        }
+        else sink->builder = GEN_NULL;
+    }
+
+    if(sink->buffer && sink->position < sink->limit) {
+        sink->buffer[sink->position] = c;
+    }
+    ++sink->position;
+}
+
 // NOTE: Be very careful with errors emitted here as a bad format specifier
 //       Can cause an infinite recurse
-gen_error_t* gen_format_variadic_list(
-        char* const restrict out_buffer, gen_size_t* const restrict out_len,
-        const gen_size_t limit, const char* const restrict format,
-        gen_variadic_list_t list) {
+static gen_error_t* gen_format_internal_variadic_list(
+        gen_format_internal_sink_t* const restrict sink,
+        const char* const restrict format, gen_variadic_list_t list) {
 
     gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
     GEN_TOOLING_AUTO gen_error_t* error;
@@ -32,13 +64,10 @@ gen_error_t* gen_format_variadic_list(
                 "`format` was `GEN_NULL`");
     }
 
-    gen_size_t pos = 0;
-
     for(gen_size_t i = 0; format[i]; ++i) {
         char c = format[i];
         if(c != '%') {
-            if(out_buffer && pos < limit) out_buffer[pos] = c;
-            ++pos;
+            gen_format_internal_put(sink, c);
             continue;
         }
 
@@ -51,8 +80,7 @@ gen_error_t* gen_format_variadic_list(
             }
 
             case '%': {
-                if(out_buffer && pos < limit) out_buffer[pos] = c;
-                ++pos;
+                gen_format_internal_put(sink, c);
 
                 break;
             }
@@ -102,10 +130,7 @@ gen_error_t* gen_format_variadic_list(
                 if(sign) numbuf[numbuf_pos++] = '-';
 
                 for(gen_size_t j = 1; j <= numbuf_pos; ++j) {
-                    if(out_buffer && pos < limit) {
-                        out_buffer[pos] = numbuf[numbuf_pos - j];
-                    }
-                    ++pos;
+                    gen_format_internal_put(sink, numbuf[numbuf_pos - j]);
                 }
 
                 break;
@@ -122,10 +147,7 @@ gen_error_t* gen_format_variadic_list(
                 }
 
                 for(gen_size_t j = 1; j <= sizeof(buf); ++j) {
-                    if(out_buffer && pos < limit) {
-                        out_buffer[pos] = buf[sizeof(buf) - j];
-                    }
-                    ++pos;
+                    gen_format_internal_put(sink, buf[sizeof(buf) - j]);
                 }
 
                 break;
@@ -146,10 +168,7 @@ gen_error_t* gen_format_variadic_list(
 
                 for(gen_size_t j = 0; j < GEN_ARRAY_LENGTH(s); ++j) {
                     for(gen_size_t k = 0; s[j][k]; ++k) {
-                        if(out_buffer && pos < limit) {
-                            out_buffer[pos] = s[j][k];
-                        }
-                        ++pos;
+                        gen_format_internal_put(sink, s[j][k]);
                     }
                 }
 
@@ -167,8 +186,7 @@ gen_error_t* gen_format_variadic_list(
                 else --i;
 
                 for(gen_size_t j = 0; j < count; ++j) {
-                    if(out_buffer && pos < limit) out_buffer[pos] = (char) a;
-                    ++pos;
+                    gen_format_internal_put(sink, (char) a);
                 }
 
                 break;
@@ -185,8 +203,7 @@ gen_error_t* gen_format_variadic_list(
                 else --i;
 
                 for(gen_size_t j = 0; j < s_limit && s[j]; ++j) {
-                    if(out_buffer && pos < limit) out_buffer[pos] = s[j];
-                    ++pos;
+                    gen_format_internal_put(sink, s[j]);
                 }
 
                 break;
@@ -212,7 +229,50 @@ gen_error_t* gen_format_variadic_list(
         }
     }
 
-    if(out_len) *out_len = pos;
+    return GEN_NULL;
+}
+
+gen_error_t* gen_format_variadic_list(
+        char* const restrict out_buffer, gen_size_t* const restrict out_len,
+        const gen_size_t limit, const char* const restrict format,
+        gen_variadic_list_t list) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_format_internal_sink_t sink = { out_buffer, limit, 0, GEN_NULL, 0 };
+    error = gen_format_internal_variadic_list(&sink, format, list);
+    if(error) return error;
+
+    if(out_len) *out_len = sink.position;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_format_internal_builder_variadic_list(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict format, gen_variadic_list_t list,
+        gen_bool_t* const restrict out_exhausted) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_size_t base = builder->length;
+    gen_format_internal_sink_t sink = {
+        gen_string_builder_internal_data(builder) + base,
+        builder->capacity - base, 0, builder, base
+    };
+
+    error = gen_format_internal_variadic_list(&sink, format, list);
+    if(error) return error;
+
+    // The sink leaves the builder's length alone while it grows it, so the
+    // output only becomes part of the string here.
+    const gen_size_t length = GEN_MINIMUM(sink.position, sink.limit);
+    builder->length = base + length;
+    gen_string_builder_internal_data(builder)[builder->length] = '\0';
+
+    *out_exhausted = sink.position > sink.limit;
 
     return GEN_NULL;
 }
@@ -0,0 +1,631 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genhash.h"
+
+#define GEN_HASH_PRIME32_1 0x9E3779B1u
+#define GEN_HASH_PRIME32_2 0x85EBCA77u
+#define GEN_HASH_PRIME32_3 0xC2B2AE3Du
+
+#define GEN_HASH_PRIME64_1 0x9E3779B185EBCA87ull
+#define GEN_HASH_PRIME64_2 0xC2B2AE3D27D4EB4Full
+#define GEN_HASH_PRIME64_3 0x165667B19E3779F9ull
+#define GEN_HASH_PRIME64_4 0x85EBCA77C2B2AE63ull
+#define GEN_HASH_PRIME64_5 0x27D4EB2F165667C5ull
+
+#define GEN_HASH_PRIME_MX1 0x165667919E3779F9ull
+#define GEN_HASH_PRIME_MX2 0x9FB21C651E98DF25ull
+
+#define GEN_HASH_STRIPE_LENGTH 64
+#define GEN_HASH_SECRET_CONSUME_RATE 8
+#define GEN_HASH_SECRET_MINIMUM_SIZE 136
+#define GEN_HASH_SECRET_LAST_ACCUMULATE_START 7
+#define GEN_HASH_SECRET_MERGE_START 11
+#define GEN_HASH_MIDSIZE_START_OFFSET 3
+#define GEN_HASH_MIDSIZE_LAST_OFFSET 17
+#define GEN_HASH_MIDSIZE_MAXIMUM 240
+
+#define GEN_HASH_SECRET_LIMIT \
+    (GEN_HASH_SECRET_SIZE - GEN_HASH_STRIPE_LENGTH)
+#define GEN_HASH_STRIPES_PER_BLOCK \
+    (GEN_HASH_SECRET_LIMIT / GEN_HASH_SECRET_CONSUME_RATE)
+#define GEN_HASH_BLOCK_LENGTH \
+    (GEN_HASH_STRIPE_LENGTH * GEN_HASH_STRIPES_PER_BLOCK)
+#define GEN_HASH_BUFFER_STRIPES \
+    (GEN_HASH_BUFFER_SIZE / GEN_HASH_STRIPE_LENGTH)
+
+static const gen_uint8_t gen_hash_default_secret[GEN_HASH_SECRET_SIZE] = {
+    0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE,
+    0x7C, 0x01, 0x81, 0x2C, 0xF7, 0x21, 0xAD, 0x1C,
+    0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB,
+    0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F,
+    0xCB, 0x79, 0xE6, 0x4E, 0xCC, 0xC0, 0xE5, 0x78,
+    0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+    0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E,
+    0xE0, 0x35, 0x90, 0xE6, 0x81, 0x3A, 0x26, 0x4C,
+    0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB,
+    0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3,
+    0x71, 0x64, 0x48, 0x97, 0xA2, 0x0D, 0xF9, 0x4E,
+    0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+    0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F,
+    0xF9, 0xDC, 0xBB, 0xC7, 0xC7, 0x0B, 0x4F, 0x1D,
+    0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31,
+    0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64,
+    0xEA, 0xC5, 0xAC, 0x83, 0x34, 0xD3, 0xEB, 0xC3,
+    0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+    0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49,
+    0xD3, 0x16, 0x55, 0x26, 0x29, 0xD4, 0x68, 0x9E,
+    0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC,
+    0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE,
+    0x45, 0xCB, 0x3A, 0x8F, 0x95, 0x16, 0x04, 0x28,
+    0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E
+};
+
+// The long-input loop works on a whole stripe of 8 lanes at once - the
+// compiler lowers this to whatever vector width the target has.
+typedef gen_uint64_t gen_hash_lanes_t __attribute__((vector_size(64)));
+
+static GEN_FORCE_INLINE gen_uint32_t gen_hash_internal_read32(
+        const gen_uint8_t* const restrict p) {
+
+    gen_uint32_t x;
+    __builtin_memcpy(&x, p, sizeof(x));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap32(x);
+#endif
+    return x;
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_read64(
+        const gen_uint8_t* const restrict p) {
+
+    gen_uint64_t x;
+    __builtin_memcpy(&x, p, sizeof(x));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    return x;
+}
+
+static GEN_FORCE_INLINE void gen_hash_internal_write64(
+        gen_uint8_t* const restrict p, gen_uint64_t x) {
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    __builtin_memcpy(p, &x, sizeof(x));
+}
+
+// NOTE: Lanes are passed around by pointer as passing 64-byte vectors by
+//       value is ABI-dependent on the enabled vector extensions.
+static GEN_FORCE_INLINE void gen_hash_internal_read_lanes(
+        gen_hash_lanes_t* const restrict out_lanes,
+        const gen_uint8_t* const restrict p) {
+
+    __builtin_memcpy(out_lanes, p, sizeof(*out_lanes));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for(gen_size_t i = 0; i < 8; ++i) {
+        (*out_lanes)[i] = __builtin_bswap64((*out_lanes)[i]);
+    }
+#endif
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_rotate(
+        const gen_uint64_t x, const gen_uint64_t n) {
+
+    return (x << n) | (x >> (64 - n));
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_fold(
+        const gen_uint64_t a, const gen_uint64_t b) {
+
+#ifdef __SIZEOF_INT128__
+    const __uint128_t product = (__uint128_t) a * b;
+    return (gen_uint64_t) product ^ (gen_uint64_t) (product >> 64);
+#else
+    const gen_uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    const gen_uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+    const gen_uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+    const gen_uint64_t hi_hi = (a >> 32) * (b >> 32);
+
+    const gen_uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    const gen_uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    const gen_uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+
+    return lower ^ upper;
+#endif
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_avalanche64(
+        gen_uint64_t x) {
+
+    x ^= x >> 33;
+    x *= GEN_HASH_PRIME64_2;
+    x ^= x >> 29;
+    x *= GEN_HASH_PRIME64_3;
+    x ^= x >> 32;
+
+    return x;
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_avalanche(
+        gen_uint64_t x) {
+
+    x ^= x >> 37;
+    x *= GEN_HASH_PRIME_MX1;
+    x ^= x >> 32;
+
+    return x;
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_rrmxmx(
+        gen_uint64_t x, const gen_size_t size) {
+
+    x ^= gen_hash_internal_rotate(x, 49) ^ gen_hash_internal_rotate(x, 24);
+    x *= GEN_HASH_PRIME_MX2;
+    x ^= (x >> 35) + size;
+    x *= GEN_HASH_PRIME_MX2;
+
+    return x ^ (x >> 28);
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_short(
+        const gen_uint8_t* const restrict p, const gen_size_t size,
+        const gen_uint8_t* const restrict secret, gen_uint64_t seed) {
+
+    if(size > 8) {
+        const gen_uint64_t lo =
+                gen_hash_internal_read64(p) ^
+                ((gen_hash_internal_read64(secret + 24) ^
+                    gen_hash_internal_read64(secret + 32)) + seed);
+        const gen_uint64_t hi =
+                gen_hash_internal_read64(p + size - 8) ^
+                ((gen_hash_internal_read64(secret + 40) ^
+                    gen_hash_internal_read64(secret + 48)) - seed);
+
+        return gen_hash_internal_avalanche(
+                size + __builtin_bswap64(lo) + hi +
+                gen_hash_internal_fold(lo, hi));
+    }
+
+    if(size >= 4) {
+        seed ^= (gen_uint64_t) __builtin_bswap32((gen_uint32_t) seed) << 32;
+
+        const gen_uint64_t x =
+                gen_hash_internal_read32(p + size - 4) +
+                ((gen_uint64_t) gen_hash_internal_read32(p) << 32);
+        const gen_uint64_t flip =
+                (gen_hash_internal_read64(secret + 8) ^
+                gen_hash_internal_read64(secret + 16)) - seed;
+
+        return gen_hash_internal_rrmxmx(x ^ flip, size);
+    }
+
+    if(size) {
+        const gen_uint32_t combined =
+                ((gen_uint32_t) p[0] << 16) |
+                ((gen_uint32_t) p[size >> 1] << 24) |
+                ((gen_uint32_t) p[size - 1]) |
+                ((gen_uint32_t) size << 8);
+        const gen_uint64_t flip =
+                (gen_hash_internal_read32(secret) ^
+                gen_hash_internal_read32(secret + 4)) + seed;
+
+        return gen_hash_internal_avalanche64(combined ^ flip);
+    }
+
+    return gen_hash_internal_avalanche64(
+            seed ^ gen_hash_internal_read64(secret + 56) ^
+            gen_hash_internal_read64(secret + 64));
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hash_internal_mix16(
+        const gen_uint8_t* const restrict p,
+        const gen_uint8_t* const restrict secret, const gen_uint64_t seed) {
+
+    return gen_hash_internal_fold(
+            gen_hash_internal_read64(p) ^
+            (gen_hash_internal_read64(secret) + seed),
+            gen_hash_internal_read64(p + 8) ^
+            (gen_hash_internal_read64(secret + 8) - seed));
+}
+
+static gen_uint64_t gen_hash_internal_medium(
+        const gen_uint8_t* const restrict p, const gen_size_t size,
+        const gen_uint8_t* const restrict secret, const gen_uint64_t seed) {
+
+    gen_uint64_t accumulator = size * GEN_HASH_PRIME64_1;
+
+    if(size <= 128) {
+        if(size > 32) {
+            if(size > 64) {
+                if(size > 96) {
+                    accumulator += gen_hash_internal_mix16(
+                            p + 48, secret + 96, seed);
+                    accumulator += gen_hash_internal_mix16(
+                            p + size - 64, secret + 112, seed);
+                }
+                accumulator += gen_hash_internal_mix16(
+                        p + 32, secret + 64, seed);
+                accumulator += gen_hash_internal_mix16(
+                        p + size - 48, secret + 80, seed);
+            }
+            accumulator += gen_hash_internal_mix16(p + 16, secret + 32, seed);
+            accumulator += gen_hash_internal_mix16(
+                    p + size - 32, secret + 48, seed);
+        }
+        accumulator += gen_hash_internal_mix16(p, secret, seed);
+        accumulator += gen_hash_internal_mix16(
+                p + size - 16, secret + 16, seed);
+
+        return gen_hash_internal_avalanche(accumulator);
+    }
+
+    for(gen_size_t i = 0; i < 8; ++i) {
+        accumulator += gen_hash_internal_mix16(
+                p + 16 * i, secret + 16 * i, seed);
+    }
+    accumulator = gen_hash_internal_avalanche(accumulator);
+
+    for(gen_size_t i = 8; i < size / 16; ++i) {
+        accumulator += gen_hash_internal_mix16(
+                p + 16 * i,
+                secret + 16 * (i - 8) + GEN_HASH_MIDSIZE_START_OFFSET, seed);
+    }
+    accumulator += gen_hash_internal_mix16(
+            p + size - 16,
+            secret + GEN_HASH_SECRET_MINIMUM_SIZE -
+            GEN_HASH_MIDSIZE_LAST_OFFSET, seed);
+
+    return gen_hash_internal_avalanche(accumulator);
+}
+
+static GEN_FORCE_INLINE void gen_hash_internal_accumulate_stripe(
+        gen_hash_lanes_t* const restrict accumulators,
+        const gen_uint8_t* const restrict p,
+        const gen_uint8_t* const restrict secret) {
+
+    gen_hash_lanes_t data;
+    gen_hash_internal_read_lanes(&data, p);
+    gen_hash_lanes_t key;
+    gen_hash_internal_read_lanes(&key, secret);
+    key ^= data;
+
+    *accumulators +=
+            __builtin_shufflevector(data, data, 1, 0, 3, 2, 5, 4, 7, 6);
+    *accumulators += (key & 0xFFFFFFFF) * (key >> 32);
+}
+
+static GEN_FORCE_INLINE void gen_hash_internal_accumulate(
+        gen_hash_lanes_t* const restrict accumulators,
+        const gen_uint8_t* const restrict p,
+        const gen_uint8_t* const restrict secret, const gen_size_t stripes) {
+
+    for(gen_size_t i = 0; i < stripes; ++i) {
+        gen_hash_internal_accumulate_stripe(
+                accumulators, p + i * GEN_HASH_STRIPE_LENGTH,
+                secret + i * GEN_HASH_SECRET_CONSUME_RATE);
+    }
+}
+
+static GEN_FORCE_INLINE void gen_hash_internal_scramble(
+        gen_hash_lanes_t* const restrict accumulators,
+        const gen_uint8_t* const restrict secret) {
+
+    gen_hash_lanes_t key;
+    gen_hash_internal_read_lanes(&key, secret);
+
+    gen_hash_lanes_t x = *accumulators;
+    x ^= x >> 47;
+    x ^= key;
+    x *= GEN_HASH_PRIME32_1;
+
+    *accumulators = x;
+}
+
+static gen_uint64_t gen_hash_internal_merge(
+        const gen_hash_lanes_t* const restrict accumulators,
+        const gen_uint8_t* const restrict secret, const gen_uint64_t start) {
+
+    gen_uint64_t result = start;
+    for(gen_size_t i = 0; i < 4; ++i) {
+        result += gen_hash_internal_fold(
+                (*accumulators)[2 * i] ^
+                gen_hash_internal_read64(secret + 16 * i),
+                (*accumulators)[2 * i + 1] ^
+                gen_hash_internal_read64(secret + 16 * i + 8));
+    }
+
+    return gen_hash_internal_avalanche(result);
+}
+
+static void gen_hash_internal_derive_secret(
+        gen_uint8_t* const restrict out_secret, const gen_uint64_t seed) {
+
+    for(gen_size_t i = 0; i < GEN_HASH_SECRET_SIZE; i += 16) {
+        gen_hash_internal_write64(
+                out_secret + i,
+                gen_hash_internal_read64(gen_hash_default_secret + i) + seed);
+        gen_hash_internal_write64(
+                out_secret + i + 8,
+                gen_hash_internal_read64(gen_hash_default_secret + i + 8) -
+                seed);
+    }
+}
+
+static const gen_hash_lanes_t gen_hash_initial_accumulators = {
+    GEN_HASH_PRIME32_3, GEN_HASH_PRIME64_1, GEN_HASH_PRIME64_2,
+    GEN_HASH_PRIME64_3, GEN_HASH_PRIME64_4, GEN_HASH_PRIME32_2,
+    GEN_HASH_PRIME64_5, GEN_HASH_PRIME32_1
+};
+
+static gen_uint64_t gen_hash_internal_long(
+        const gen_uint8_t* const restrict p, const gen_size_t size,
+        const gen_uint64_t seed) {
+
+    gen_uint8_t derived[GEN_HASH_SECRET_SIZE];
+    const gen_uint8_t* secret = gen_hash_default_secret;
+    if(seed) {
+        gen_hash_internal_derive_secret(derived, seed);
+        secret = derived;
+    }
+
+    gen_hash_lanes_t accumulators = gen_hash_initial_accumulators;
+
+    const gen_size_t blocks = (size - 1) / GEN_HASH_BLOCK_LENGTH;
+    for(gen_size_t i = 0; i < blocks; ++i) {
+        gen_hash_internal_accumulate(
+                &accumulators, p + i * GEN_HASH_BLOCK_LENGTH, secret,
+                GEN_HASH_STRIPES_PER_BLOCK);
+        gen_hash_internal_scramble(
+                &accumulators, secret + GEN_HASH_SECRET_LIMIT);
+    }
+
+    const gen_size_t stripes =
+            ((size - 1) - GEN_HASH_BLOCK_LENGTH * blocks) /
+            GEN_HASH_STRIPE_LENGTH;
+    gen_hash_internal_accumulate(
+            &accumulators, p + blocks * GEN_HASH_BLOCK_LENGTH, secret,
+            stripes);
+    gen_hash_internal_accumulate_stripe(
+            &accumulators, p + size - GEN_HASH_STRIPE_LENGTH,
+            secret + GEN_HASH_SECRET_LIMIT -
+            GEN_HASH_SECRET_LAST_ACCUMULATE_START);
+
+    return gen_hash_internal_merge(
+            &accumulators, secret + GEN_HASH_SECRET_MERGE_START,
+            size * GEN_HASH_PRIME64_1);
+}
+
+gen_uint64_t gen_hash_internal_compute(
+        const void* const restrict data, const gen_size_t size,
+        const gen_uint64_t seed) {
+
+    const gen_uint8_t* const p = data;
+
+    if(size <= 16) {
+        return gen_hash_internal_short(
+                p, size, gen_hash_default_secret, seed);
+    }
+
+    if(size <= GEN_HASH_MIDSIZE_MAXIMUM) {
+        return gen_hash_internal_medium(
+                p, size, gen_hash_default_secret, seed);
+    }
+
+    return gen_hash_internal_long(p, size, seed);
+}
+
+gen_error_t* gen_hash(
+        const void* const restrict data, const gen_size_t size,
+        const gen_uint64_t seed, gen_uint64_t* const restrict out_hash) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!data && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`data` was `GEN_NULL`");
+    }
+
+    if(!out_hash) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_hash` was `GEN_NULL`");
+    }
+
+    *out_hash = gen_hash_internal_compute(data, size, seed);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hash_begin(
+        const gen_uint64_t seed, gen_hash_state_t* const restrict out_state) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_state) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_state` was `GEN_NULL`");
+    }
+
+    *out_state = (gen_hash_state_t) {0};
+    out_state->seed = seed;
+
+    __builtin_memcpy(
+            out_state->accumulators, &gen_hash_initial_accumulators,
+            sizeof(out_state->accumulators));
+    gen_hash_internal_derive_secret(out_state->secret, seed);
+
+    return GEN_NULL;
+}
+
+// Feeds whole stripes into the accumulators, scrambling at block boundaries.
+static void gen_hash_internal_consume(
+        gen_hash_lanes_t* const restrict accumulators,
+        gen_size_t* const restrict stripes_so_far,
+        const gen_uint8_t* const restrict p, const gen_size_t stripes,
+        const gen_uint8_t* const restrict secret) {
+
+    const gen_size_t to_end = GEN_HASH_STRIPES_PER_BLOCK - *stripes_so_far;
+
+    if(to_end <= stripes) {
+        gen_hash_internal_accumulate(
+                accumulators, p,
+                secret + *stripes_so_far * GEN_HASH_SECRET_CONSUME_RATE,
+                to_end);
+        gen_hash_internal_scramble(
+                accumulators, secret + GEN_HASH_SECRET_LIMIT);
+        gen_hash_internal_accumulate(
+                accumulators, p + to_end * GEN_HASH_STRIPE_LENGTH, secret,
+                stripes - to_end);
+
+        *stripes_so_far = stripes - to_end;
+    }
+    else {
+        gen_hash_internal_accumulate(
+                accumulators, p,
+                secret + *stripes_so_far * GEN_HASH_SECRET_CONSUME_RATE,
+                stripes);
+
+        *stripes_so_far += stripes;
+    }
+}
+
+gen_error_t* gen_hash_update(
+        gen_hash_state_t* const restrict state, const void* const restrict data,
+        const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!state) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`state` was `GEN_NULL`");
+    }
+
+    if(!data && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`data` was `GEN_NULL`");
+    }
+
+    const gen_uint8_t* p = data;
+    const gen_uint8_t* const end = p + size;
+
+    state->length += size;
+
+    if(state->buffered + size <= GEN_HASH_BUFFER_SIZE) {
+        __builtin_memcpy(state->buffer + state->buffered, p, size);
+        state->buffered += size;
+
+        return GEN_NULL;
+    }
+
+    gen_hash_lanes_t accumulators;
+    __builtin_memcpy(
+            &accumulators, state->accumulators, sizeof(accumulators));
+
+    // We always leave some input buffered so that the final stripe can be
+    // handled specially by `gen_hash_end`.
+    if(state->buffered) {
+        const gen_size_t fill = GEN_HASH_BUFFER_SIZE - state->buffered;
+        __builtin_memcpy(state->buffer + state->buffered, p, fill);
+        p += fill;
+
+        gen_hash_internal_consume(
+                &accumulators, &state->stripes, state->buffer,
+                GEN_HASH_BUFFER_STRIPES, state->secret);
+        state->buffered = 0;
+    }
+
+    if((gen_size_t) (end - p) > GEN_HASH_BUFFER_SIZE) {
+        do {
+            gen_hash_internal_consume(
+                    &accumulators, &state->stripes, p,
+                    GEN_HASH_BUFFER_STRIPES, state->secret);
+            p += GEN_HASH_BUFFER_SIZE;
+        } while((gen_size_t) (end - p) > GEN_HASH_BUFFER_SIZE);
+
+        __builtin_memcpy(
+                state->buffer + GEN_HASH_BUFFER_SIZE - GEN_HASH_STRIPE_LENGTH,
+                p - GEN_HASH_STRIPE_LENGTH, GEN_HASH_STRIPE_LENGTH);
+    }
+
+    __builtin_memcpy(state->buffer, p, (gen_size_t) (end - p));
+    state->buffered = (gen_size_t) (end - p);
+
+    __builtin_memcpy(
+            state->accumulators, &accumulators, sizeof(accumulators));
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hash_end(
+        const gen_hash_state_t* const restrict state,
+        gen_uint64_t* const restrict out_hash) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!state) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`state` was `GEN_NULL`");
+    }
+
+    if(!out_hash) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_hash` was `GEN_NULL`");
+    }
+
+    if(state->length <= GEN_HASH_MIDSIZE_MAXIMUM) {
+        *out_hash = gen_hash_internal_compute(
+                state->buffer, state->length, state->seed);
+
+        return GEN_NULL;
+    }
+
+    gen_hash_lanes_t accumulators;
+    __builtin_memcpy(
+            &accumulators, state->accumulators, sizeof(accumulators));
+
+    const gen_uint8_t* const last_secret =
+            state->secret + GEN_HASH_SECRET_LIMIT -
+            GEN_HASH_SECRET_LAST_ACCUMULATE_START;
+
+    if(state->buffered >= GEN_HASH_STRIPE_LENGTH) {
+        gen_size_t stripes = state->stripes;
+        gen_hash_internal_consume(
+                &accumulators, &stripes, state->buffer,
+                (state->buffered - 1) / GEN_HASH_STRIPE_LENGTH, state->secret);
+        gen_hash_internal_accumulate_stripe(
+                &accumulators,
+                state->buffer + state->buffered - GEN_HASH_STRIPE_LENGTH,
+                last_secret);
+    }
+    else {
+        // The last stripe straddles the previous buffer's tail.
+        gen_uint8_t stripe[GEN_HASH_STRIPE_LENGTH];
+        const gen_size_t catchup = GEN_HASH_STRIPE_LENGTH - state->buffered;
+
+        __builtin_memcpy(
+                stripe, state->buffer + GEN_HASH_BUFFER_SIZE - catchup,
+                catchup);
+        __builtin_memcpy(stripe + catchup, state->buffer, state->buffered);
+
+        gen_hash_internal_accumulate_stripe(
+                &accumulators, stripe, last_secret);
+    }
+
+    *out_hash = gen_hash_internal_merge(
+            &accumulators, state->secret + GEN_HASH_SECRET_MERGE_START,
+            state->length * GEN_HASH_PRIME64_1);
+
+    return GEN_NULL;
+}
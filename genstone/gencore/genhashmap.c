@@ -0,0 +1,605 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genhashmap.h"
+#include "include/genhash.h"
+
+// Control bytes are `GEN_HASHMAP_EMPTY`, `GEN_HASHMAP_DELETED` or the low 7
+// bits of a full slot's hash. The first group's worth of controls is mirrored
+// past the end of the array so that a group can be loaded from any slot.
+#define GEN_HASHMAP_EMPTY ((gen_uint8_t) 0x80)
+#define GEN_HASHMAP_DELETED ((gen_uint8_t) 0xFE)
+
+#define GEN_HASHMAP_MINIMUM_ALIGNMENT 8
+
+#if defined(__SSE2__)
+#define GEN_HASHMAP_GROUP_WIDTH 16
+#define GEN_HASHMAP_GROUP_SHIFT 0
+
+typedef char gen_hashmap_group_t __attribute__((vector_size(16)));
+typedef gen_uint32_t gen_hashmap_mask_t;
+
+static GEN_FORCE_INLINE gen_hashmap_group_t gen_hashmap_internal_load(
+        const gen_uint8_t* const restrict controls) {
+
+    gen_hashmap_group_t group;
+    __builtin_memcpy(&group, controls, sizeof(group));
+    return group;
+}
+
+static GEN_FORCE_INLINE gen_hashmap_mask_t gen_hashmap_internal_match(
+        const gen_hashmap_group_t group, const gen_uint8_t control) {
+
+    const gen_hashmap_group_t splat =
+            (gen_hashmap_group_t) {0} + (char) control;
+    const int mask =
+            __builtin_ia32_pmovmskb128((gen_hashmap_group_t) (group == splat));
+
+    return (gen_hashmap_mask_t) mask;
+}
+
+static GEN_FORCE_INLINE gen_hashmap_mask_t gen_hashmap_internal_match_empty(
+        const gen_hashmap_group_t group) {
+
+    return gen_hashmap_internal_match(group, GEN_HASHMAP_EMPTY);
+}
+
+static GEN_FORCE_INLINE gen_hashmap_mask_t gen_hashmap_internal_match_free(
+        const gen_hashmap_group_t group) {
+
+    const int mask = __builtin_ia32_pmovmskb128(group);
+
+    return (gen_hashmap_mask_t) mask;
+}
+
+static GEN_FORCE_INLINE gen_size_t gen_hashmap_internal_leading(
+        const gen_hashmap_mask_t mask) {
+
+    const int zeroes = __builtin_clz(mask);
+
+    return (gen_size_t) zeroes - 16;
+}
+#else
+#define GEN_HASHMAP_GROUP_WIDTH 8
+#define GEN_HASHMAP_GROUP_SHIFT 3
+
+#define GEN_HASHMAP_LSBS 0x0101010101010101ull
+#define GEN_HASHMAP_MSBS 0x8080808080808080ull
+
+typedef gen_uint64_t gen_hashmap_group_t;
+typedef gen_uint64_t gen_hashmap_mask_t;
+
+static GEN_FORCE_INLINE gen_hashmap_group_t gen_hashmap_internal_load(
+        const gen_uint8_t* const restrict controls) {
+
+    gen_hashmap_group_t group;
+    __builtin_memcpy(&group, controls, sizeof(group));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    group = __builtin_bswap64(group);
+#endif
+    return group;
+}
+
+// NOTE: This can report false positives where a byte following a true match
+//       differs only in its lowest bit - we always compare keys on a match so
+//       this is harmless.
+static GEN_FORCE_INLINE gen_hashmap_mask_t gen_hashmap_internal_match(
+        const gen_hashmap_group_t group, const gen_uint8_t control) {
+
+    const gen_hashmap_group_t x = group ^ (GEN_HASHMAP_LSBS * control);
+    return (x - GEN_HASHMAP_LSBS) & ~x & GEN_HASHMAP_MSBS;
+}
+
+// Empty and deleted are the only controls with the top bit set, and only
+// deleted also has the next bit set.
+static GEN_FORCE_INLINE gen_hashmap_mask_t gen_hashmap_internal_match_empty(
+        const gen_hashmap_group_t group) {
+
+    return group & ~(group << 1) & GEN_HASHMAP_MSBS;
+}
+
+static GEN_FORCE_INLINE gen_hashmap_mask_t gen_hashmap_internal_match_free(
+        const gen_hashmap_group_t group) {
+
+    return group & GEN_HASHMAP_MSBS;
+}
+
+static GEN_FORCE_INLINE gen_size_t gen_hashmap_internal_leading(
+        const gen_hashmap_mask_t mask) {
+
+    return GEN_LEADING_ZEROES(mask) >> GEN_HASHMAP_GROUP_SHIFT;
+}
+#endif
+
+static GEN_FORCE_INLINE gen_size_t gen_hashmap_internal_trailing(
+        const gen_hashmap_mask_t mask) {
+
+    const int zeroes = __builtin_ctzll(mask);
+
+    return (gen_size_t) zeroes >> GEN_HASHMAP_GROUP_SHIFT;
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hashmap_internal_read(
+        const gen_uint8_t* const restrict p, const gen_size_t size) {
+
+    gen_uint64_t x = 0;
+    __builtin_memcpy(&x, p, size);
+    return x;
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_hashmap_internal_hash(
+        const void* const restrict key, const gen_size_t size) {
+
+    return gen_hash_internal_compute(key, size, 0);
+}
+
+static GEN_FORCE_INLINE gen_bool_t gen_hashmap_internal_equal(
+        const gen_uint8_t* const restrict a,
+        const gen_uint8_t* const restrict b, const gen_size_t size) {
+
+    if(size == sizeof(gen_uint64_t)) {
+        return gen_hashmap_internal_read(a, 8) ==
+                gen_hashmap_internal_read(b, 8);
+    }
+
+    for(gen_size_t i = 0; i < size; ++i) if(a[i] != b[i]) return gen_false;
+
+    return gen_true;
+}
+
+static GEN_FORCE_INLINE void gen_hashmap_internal_copy(
+        gen_uint8_t* const restrict to, const gen_uint8_t* const restrict from,
+        const gen_size_t size) {
+
+    for(gen_size_t i = 0; i < size; ++i) to[i] = from[i];
+}
+
+static GEN_FORCE_INLINE void gen_hashmap_internal_set_control(
+        gen_hashmap_t* const restrict hashmap, const gen_size_t slot,
+        const gen_uint8_t control) {
+
+    hashmap->controls[slot] = control;
+    if(slot < GEN_HASHMAP_GROUP_WIDTH) {
+        hashmap->controls[hashmap->capacity + slot] = control;
+    }
+}
+
+static GEN_FORCE_INLINE gen_uint8_t* gen_hashmap_internal_entry(
+        const gen_hashmap_t* const restrict hashmap, const gen_size_t slot) {
+
+    return hashmap->entries + slot * hashmap->stride;
+}
+
+static gen_size_t gen_hashmap_internal_find(
+        const gen_hashmap_t* const restrict hashmap,
+        const void* const restrict key, const gen_uint64_t hash) {
+
+    const gen_size_t mask = hashmap->capacity - 1;
+    const gen_uint8_t control = (gen_uint8_t) (hash & 0x7F);
+
+    gen_size_t position = (gen_size_t) (hash >> 7) & mask;
+    for(gen_size_t step = 0;;) {
+        const gen_hashmap_group_t group =
+                gen_hashmap_internal_load(hashmap->controls + position);
+
+        gen_hashmap_mask_t matches = gen_hashmap_internal_match(group, control);
+        while(matches) {
+            const gen_size_t slot =
+                    (position + gen_hashmap_internal_trailing(matches)) & mask;
+
+            if(gen_hashmap_internal_equal(
+                    gen_hashmap_internal_entry(hashmap, slot), key,
+                    hashmap->key_size)) {
+
+                return slot;
+            }
+
+            matches &= matches - 1;
+        }
+
+        if(gen_hashmap_internal_match_empty(group)) return GEN_SIZE_MAX;
+
+        step += GEN_HASHMAP_GROUP_WIDTH;
+        position = (position + step) & mask;
+    }
+}
+
+static gen_size_t gen_hashmap_internal_find_free(
+        const gen_hashmap_t* const restrict hashmap, const gen_uint64_t hash) {
+
+    const gen_size_t mask = hashmap->capacity - 1;
+
+    gen_size_t position = (gen_size_t) (hash >> 7) & mask;
+    for(gen_size_t step = 0;;) {
+        const gen_hashmap_mask_t available = gen_hashmap_internal_match_free(
+                gen_hashmap_internal_load(hashmap->controls + position));
+
+        if(available) {
+            return (position + gen_hashmap_internal_trailing(available)) & mask;
+        }
+
+        step += GEN_HASHMAP_GROUP_WIDTH;
+        position = (position + step) & mask;
+    }
+}
+
+static gen_size_t gen_hashmap_internal_capacity_for(const gen_size_t count) {
+    gen_size_t capacity = GEN_HASHMAP_GROUP_WIDTH;
+    while(capacity - capacity / 8 < count) capacity *= 2;
+
+    return capacity;
+}
+
+static gen_error_t* gen_hashmap_internal_allocate(
+        gen_hashmap_t* const restrict hashmap, const gen_size_t capacity) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint8_t* controls =
+            hashmap->allocator.malloc(capacity + GEN_HASHMAP_GROUP_WIDTH);
+    if(!controls) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate controls for %uz slots", capacity);
+    }
+
+    gen_uint8_t* entries =
+            hashmap->allocator.malloc(capacity * hashmap->stride);
+    if(!entries) {
+        hashmap->allocator.free(controls);
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate entries for %uz slots", capacity);
+    }
+
+    for(gen_size_t i = 0; i < capacity + GEN_HASHMAP_GROUP_WIDTH; ++i) {
+        controls[i] = GEN_HASHMAP_EMPTY;
+    }
+
+    hashmap->controls = controls;
+    hashmap->entries = entries;
+    hashmap->capacity = capacity;
+    hashmap->length = 0;
+    hashmap->growth_left = capacity - capacity / 8;
+
+    return GEN_NULL;
+}
+
+// Moves every entry into a fresh table of `capacity` slots, which also drops
+// any accumulated tombstones.
+static gen_error_t* gen_hashmap_internal_rehash(
+        gen_hashmap_t* const restrict hashmap, const gen_size_t capacity) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_hashmap_t old = *hashmap;
+
+    error = gen_hashmap_internal_allocate(hashmap, capacity);
+    if(error) return error;
+
+    for(gen_size_t i = 0; i < old.capacity; ++i) {
+        if(old.controls[i] & 0x80) continue;
+
+        const gen_uint8_t* const entry = gen_hashmap_internal_entry(&old, i);
+        const gen_uint64_t hash =
+                gen_hashmap_internal_hash(entry, hashmap->key_size);
+        const gen_size_t slot = gen_hashmap_internal_find_free(hashmap, hash);
+
+        gen_hashmap_internal_set_control(
+                hashmap, slot, (gen_uint8_t) (hash & 0x7F));
+        gen_hashmap_internal_copy(
+                gen_hashmap_internal_entry(hashmap, slot), entry,
+                hashmap->stride);
+    }
+
+    hashmap->length = old.length;
+    hashmap->growth_left -= old.length;
+
+    hashmap->allocator.free(old.controls);
+    hashmap->allocator.free(old.entries);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hashmap_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_size_t key_size, const gen_size_t value_size,
+        const gen_size_t initial_capacity,
+        gen_hashmap_t* const restrict out_hashmap) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!allocator) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`allocator` was `GEN_NULL`");
+    }
+
+    if(!key_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`key_size` was 0");
+    }
+
+    if(!out_hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_hashmap` was `GEN_NULL`");
+    }
+
+    *out_hashmap = (gen_hashmap_t) {0};
+    out_hashmap->allocator = *allocator;
+    out_hashmap->key_size = key_size;
+    out_hashmap->value_size = value_size;
+    out_hashmap->value_offset =
+            GEN_NEXT_NEAREST(key_size, GEN_HASHMAP_MINIMUM_ALIGNMENT);
+    out_hashmap->stride = GEN_NEXT_NEAREST(
+            out_hashmap->value_offset + value_size,
+            GEN_HASHMAP_MINIMUM_ALIGNMENT);
+
+    return gen_hashmap_internal_allocate(
+            out_hashmap, gen_hashmap_internal_capacity_for(initial_capacity));
+}
+
+gen_error_t* gen_hashmap_destroy(gen_hashmap_t* const restrict hashmap) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    hashmap->allocator.free(hashmap->controls);
+    hashmap->allocator.free(hashmap->entries);
+
+    *hashmap = (gen_hashmap_t) {0};
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hashmap_reserve(
+        gen_hashmap_t* const restrict hashmap, const gen_size_t count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    const gen_size_t capacity = gen_hashmap_internal_capacity_for(count);
+    if(capacity <= hashmap->capacity) return GEN_NULL;
+
+    return gen_hashmap_internal_rehash(hashmap, capacity);
+}
+
+gen_error_t* gen_hashmap_clear(gen_hashmap_t* const restrict hashmap) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    const gen_size_t controls = hashmap->capacity + GEN_HASHMAP_GROUP_WIDTH;
+    for(gen_size_t i = 0; i < controls; ++i) {
+        hashmap->controls[i] = GEN_HASHMAP_EMPTY;
+    }
+
+    hashmap->length = 0;
+    hashmap->growth_left = hashmap->capacity - hashmap->capacity / 8;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hashmap_insert(
+        gen_hashmap_t* const restrict hashmap, const void* const restrict key,
+        const void* const restrict value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    if(!key) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`key` was `GEN_NULL`");
+    }
+
+    if(!value && hashmap->value_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`value` was `GEN_NULL`");
+    }
+
+    const gen_uint64_t hash =
+            gen_hashmap_internal_hash(key, hashmap->key_size);
+
+    gen_size_t slot = gen_hashmap_internal_find(hashmap, key, hash);
+    if(slot == GEN_SIZE_MAX) {
+        slot = gen_hashmap_internal_find_free(hashmap, hash);
+
+        if(!hashmap->growth_left &&
+            hashmap->controls[slot] == GEN_HASHMAP_EMPTY) {
+
+            // Rehashing in place is enough if tombstones are what is using up
+            // the growth allowance.
+            gen_size_t capacity = hashmap->capacity;
+            if(hashmap->length > capacity / 2 - capacity / 16) capacity *= 2;
+
+            error = gen_hashmap_internal_rehash(hashmap, capacity);
+            if(error) return error;
+
+            slot = gen_hashmap_internal_find_free(hashmap, hash);
+        }
+
+        if(hashmap->controls[slot] == GEN_HASHMAP_EMPTY) {
+            --hashmap->growth_left;
+        }
+
+        gen_hashmap_internal_set_control(
+                hashmap, slot, (gen_uint8_t) (hash & 0x7F));
+        gen_hashmap_internal_copy(
+                gen_hashmap_internal_entry(hashmap, slot), key,
+                hashmap->key_size);
+        ++hashmap->length;
+    }
+
+    gen_hashmap_internal_copy(
+            gen_hashmap_internal_entry(hashmap, slot) + hashmap->value_offset,
+            value, hashmap->value_size);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hashmap_get(
+        const gen_hashmap_t* const restrict hashmap,
+        const void* const restrict key, void** const restrict out_value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    if(!key) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`key` was `GEN_NULL`");
+    }
+
+    if(!out_value) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_value` was `GEN_NULL`");
+    }
+
+    const gen_size_t slot = gen_hashmap_internal_find(
+            hashmap, key, gen_hashmap_internal_hash(key, hashmap->key_size));
+
+    if(slot == GEN_SIZE_MAX) *out_value = GEN_NULL;
+    else {
+        *out_value =
+            gen_hashmap_internal_entry(hashmap, slot) + hashmap->value_offset;
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hashmap_remove(
+        gen_hashmap_t* const restrict hashmap, const void* const restrict key,
+        gen_bool_t* const restrict out_removed) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    if(!key) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`key` was `GEN_NULL`");
+    }
+
+    const gen_size_t slot = gen_hashmap_internal_find(
+            hashmap, key, gen_hashmap_internal_hash(key, hashmap->key_size));
+
+    if(out_removed) *out_removed = slot != GEN_SIZE_MAX;
+    if(slot == GEN_SIZE_MAX) return GEN_NULL;
+
+    // A slot can go straight back to empty if no group containing it was ever
+    // seen without an empty slot, as then no probe could have continued past
+    // it.
+    const gen_size_t mask = hashmap->capacity - 1;
+    const gen_hashmap_mask_t empty_before = gen_hashmap_internal_match_empty(
+            gen_hashmap_internal_load(
+                hashmap->controls +
+                ((slot - GEN_HASHMAP_GROUP_WIDTH) & mask)));
+    const gen_hashmap_mask_t empty_after = gen_hashmap_internal_match_empty(
+            gen_hashmap_internal_load(hashmap->controls + slot));
+
+    const gen_bool_t never_full =
+            empty_before && empty_after &&
+            gen_hashmap_internal_trailing(empty_after) +
+            gen_hashmap_internal_leading(empty_before) <
+            GEN_HASHMAP_GROUP_WIDTH;
+
+    if(never_full) {
+        gen_hashmap_internal_set_control(hashmap, slot, GEN_HASHMAP_EMPTY);
+        ++hashmap->growth_left;
+    }
+    else {
+        gen_hashmap_internal_set_control(hashmap, slot, GEN_HASHMAP_DELETED);
+    }
+
+    --hashmap->length;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_hashmap_next(
+        const gen_hashmap_t* const restrict hashmap,
+        gen_size_t* const restrict position,
+        const void** const restrict out_key, void** const restrict out_value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!hashmap) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`hashmap` was `GEN_NULL`");
+    }
+
+    if(!position) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`position` was `GEN_NULL`");
+    }
+
+    if(!out_key) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_key` was `GEN_NULL`");
+    }
+
+    gen_size_t i = *position;
+    for(; i < hashmap->capacity && (hashmap->controls[i] & 0x80); ++i);
+
+    if(i >= hashmap->capacity) {
+        *position = hashmap->capacity;
+        *out_key = GEN_NULL;
+        if(out_value) *out_value = GEN_NULL;
+
+        return GEN_NULL;
+    }
+
+    gen_uint8_t* const entry = gen_hashmap_internal_entry(hashmap, i);
+
+    *position = i + 1;
+    *out_key = entry;
+    if(out_value) *out_value = entry + hashmap->value_offset;
+
+    return GEN_NULL;
+}
@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genio.h"
+
+#include <genbackends.h>
+
+GEN_BACKENDS_PROC(file_open, gen_error_t*)
+gen_error_t* gen_file_open(
+        const char* const restrict path, const gen_file_access_t access,
+        gen_file_t* const restrict out_file) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!path) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`path` was `GEN_NULL`");
+    }
+
+    if(!(access & (GEN_FILE_ACCESS_READ | GEN_FILE_ACCESS_WRITE))) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`access` did not request reading or writing");
+    }
+
+    if((access & GEN_FILE_ACCESS_APPEND) && !(access & GEN_FILE_ACCESS_WRITE)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`access` requested appending without writing");
+    }
+
+    if((access & GEN_FILE_ACCESS_TRUNCATE) &&
+            !(access & GEN_FILE_ACCESS_WRITE)) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`access` requested truncating without writing");
+    }
+
+    if(!out_file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_file` was `GEN_NULL`");
+    }
+
+    return gen_backends_file_open(path, access, out_file);
+}
+
+GEN_BACKENDS_PROC(file_close, gen_error_t*)
+gen_error_t* gen_file_close(gen_file_t* const restrict file) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    return gen_backends_file_close(file);
+}
+
+GEN_BACKENDS_PROC(file_get_standard, gen_error_t*)
+gen_error_t* gen_file_get_standard(
+        const gen_file_standard_t standard,
+        gen_file_t* const restrict out_file) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_file` was `GEN_NULL`");
+    }
+
+    out_file->access =
+            standard == GEN_FILE_STANDARD_INPUT ?
+            GEN_FILE_ACCESS_READ : GEN_FILE_ACCESS_WRITE;
+
+    return gen_backends_file_get_standard(standard, out_file);
+}
+
+GEN_BACKENDS_PROC(file_read, gen_error_t*)
+gen_error_t* gen_file_read(
+        const gen_file_t* const restrict file, void* const restrict buffer,
+        const gen_size_t size, gen_size_t* const restrict out_read) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    if(!buffer && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`buffer` was `GEN_NULL`");
+    }
+
+    if(!out_read) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_read` was `GEN_NULL`");
+    }
+
+    if(!(file->access & GEN_FILE_ACCESS_READ)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                "`file` was not opened for reading");
+    }
+
+    *out_read = 0;
+    if(!size) return GEN_NULL;
+
+    return gen_backends_file_read(file, buffer, size, out_read);
+}
+
+GEN_BACKENDS_PROC(file_write, gen_error_t*)
+gen_error_t* gen_file_write(
+        const gen_file_t* const restrict file,
+        const void* const restrict buffer, const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    if(!buffer && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`buffer` was `GEN_NULL`");
+    }
+
+    if(!(file->access & GEN_FILE_ACCESS_WRITE)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                "`file` was not opened for writing");
+    }
+
+    if(!size) return GEN_NULL;
+
+    return gen_backends_file_write(file, buffer, size);
+}
+
+GEN_BACKENDS_PROC(file_advise, gen_error_t*)
+gen_error_t* gen_file_advise(
+        const gen_file_t* const restrict file, const gen_file_advice_t advice) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    if(advice > GEN_FILE_ADVICE_DONT_NEED) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`advice` was not a valid advice");
+    }
+
+    return gen_backends_file_advise(file, advice);
+}
+
+GEN_BACKENDS_PROC(file_get_size, gen_error_t*)
+gen_error_t* gen_file_get_size(
+        const gen_file_t* const restrict file,
+        gen_size_t* const restrict out_size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    if(!out_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_size` was `GEN_NULL`");
+    }
+
+    return gen_backends_file_get_size(file, out_size);
+}
+
+GEN_BACKENDS_PROC(file_map, gen_error_t*)
+gen_error_t* gen_file_map(
+        const gen_file_t* const restrict file, const gen_file_access_t access,
+        gen_file_mapping_t* const restrict out_mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    const gen_file_access_t extra =
+            GEN_FILE_ACCESS_CREATE | GEN_FILE_ACCESS_APPEND |
+            GEN_FILE_ACCESS_TRUNCATE;
+    if(!(access & GEN_FILE_ACCESS_READ) || (access & extra)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`access` must request reading and may only add writing");
+    }
+
+    if((access & file->access) != access) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                "`access` requested more than `file` was opened with");
+    }
+
+    // Appending files only write at the end, so writes made through a mapping
+    // could never land where they were made.
+    if((access & GEN_FILE_ACCESS_WRITE) &&
+            (file->access & GEN_FILE_ACCESS_APPEND)) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                "`file` was opened for appending so cannot be mapped writable");
+    }
+
+    if(!out_mapping) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_mapping` was `GEN_NULL`");
+    }
+
+    *out_mapping = (gen_file_mapping_t) {0};
+    out_mapping->file = file;
+    out_mapping->access = access;
+
+    error = gen_backends_file_get_size(file, &out_mapping->size);
+    if(error) return error;
+
+    // Empty files can't be mapped so we hand back an empty view directly.
+    if(!out_mapping->size) return GEN_NULL;
+
+    return gen_backends_file_map(file, access, out_mapping);
+}
+
+GEN_BACKENDS_PROC(file_unmap, gen_error_t*)
+gen_error_t* gen_file_unmap(gen_file_mapping_t* const restrict mapping) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!mapping) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`mapping` was `GEN_NULL`");
+    }
+
+    if(mapping->data) {
+        error = gen_backends_file_unmap(mapping);
+        if(error) return error;
+    }
+
+    *mapping = (gen_file_mapping_t) {0};
+
+    return GEN_NULL;
+}
+
+GEN_BACKENDS_PROC(file_mapping_advise, gen_error_t*)
+gen_error_t* gen_file_mapping_advise(
+        const gen_file_mapping_t* const restrict mapping,
+        const gen_file_advice_t advice) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!mapping) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`mapping` was `GEN_NULL`");
+    }
+
+    if(advice > GEN_FILE_ADVICE_DONT_NEED) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`advice` was not a valid advice");
+    }
+
+    if(!mapping->data) return GEN_NULL;
+
+    return gen_backends_file_mapping_advise(mapping, advice);
+}
+
+GEN_BACKENDS_PROC(file_mapping_sync, gen_error_t*)
+gen_error_t* gen_file_mapping_sync(
+        const gen_file_mapping_t* const restrict mapping) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!mapping) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`mapping` was `GEN_NULL`");
+    }
+
+    if(!mapping->data || !(mapping->access & GEN_FILE_ACCESS_WRITE)) {
+        return GEN_NULL;
+    }
+
+    return gen_backends_file_mapping_sync(mapping);
+}
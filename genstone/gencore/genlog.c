@@ -3,44 +3,72 @@
 
 #include "include/genlog.h"
 #include "include/genformat.h"
+#include "include/genhash.h"
+#include "include/genmetrics.h"
+#include "include/genrecorder.h"
+#include "include/genstringbuilder.h"
+#include "include/gentime.h"
 
 #include <genbackends.h>
 
-#ifndef GEN_LOG_MAXIMUM_FORMATTED_LENGTH
-#define GEN_LOG_MAXIMUM_FORMATTED_LENGTH 8192
-#endif
-
 #ifndef GEN_LOG_MAXIMUM_CONTEXT_LENGTH
 #define GEN_LOG_MAXIMUM_CONTEXT_LENGTH 32
 #endif
 
-GEN_BACKENDS_PROC(terminal_write, void)
-gen_error_t* gen_log(
+#ifndef GEN_LOG_RATE_LIMIT_SITES
+#define GEN_LOG_RATE_LIMIT_SITES 256
+#endif
+
+#ifndef GEN_LOG_RATE_LIMIT_PER_SECOND
+#define GEN_LOG_RATE_LIMIT_PER_SECOND 100
+#endif
+
+#ifndef GEN_LOG_RATE_LIMIT_BURST
+#define GEN_LOG_RATE_LIMIT_BURST 200
+#endif
+
+#ifndef GEN_LOG_SUPPRESSION_REPORT_INTERVAL
+#define GEN_LOG_SUPPRESSION_REPORT_INTERVAL GEN_TIME_NANOSECONDS_PER_SECOND
+#endif
+
+static gen_bool_t gen_log_internal_timestamps = gen_false;
+
+gen_error_t* gen_log_set_timestamps(const gen_bool_t enabled) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    __atomic_store_n(&gen_log_internal_timestamps, enabled, __ATOMIC_RELAXED);
+
+    return GEN_NULL;
+}
+
+// Starts `line` with the timestamp, level and context which prefix messages.
+static gen_error_t* gen_log_internal_compose(
+        gen_string_builder_t* const restrict line, const gen_uint64_t time,
         const gen_log_level_t level, const char* const restrict context,
-        const char* const restrict format, ...) {
+        gen_size_t* const restrict out_timestamp_length) {
 
     gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
     GEN_TOOLING_AUTO gen_error_t* error;
 
-    if(!context) {
-        return gen_error_attach_backtrace(
-                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
-                "`context` was `GEN_NULL`");
-    }
+    if(__atomic_load_n(&gen_log_internal_timestamps, __ATOMIC_RELAXED)) {
+        const gen_uint64_t seconds = time / GEN_TIME_NANOSECONDS_PER_SECOND;
+        gen_uint64_t microseconds =
+                (time % GEN_TIME_NANOSECONDS_PER_SECOND) / 1000;
 
-    if(!format) {
-        return gen_error_attach_backtrace(
-                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
-                "`format` was `GEN_NULL`");
-    }
+        // We don't have zero-padded formatting so the fraction is done by
+        // hand.
+        char fraction[7] = {0};
+        for(gen_size_t i = 6; i--; microseconds /= 10) {
+            fraction[i] = (char) ('0' + microseconds % 10);
+        }
 
-    GEN_VARIADIC_LIST_AUTO gen_variadic_list_t list;
-    gen_variadic_list_start(list, format);
+        error = gen_string_builder_format(
+                line, "[%ul.%t] ", seconds, fraction);
+        if(error) return error;
+    }
 
-    char message[GEN_LOG_MAXIMUM_FORMATTED_LENGTH + 1] = {0};
-    error = gen_format_variadic_list(
-            message, GEN_NULL, GEN_LOG_MAXIMUM_FORMATTED_LENGTH, format, list);
-    if(error) return error;
+    if(out_timestamp_length) *out_timestamp_length = line->length;
 
     const char* levels[] = {
         [GEN_LOG_LEVEL_TRACE]   = "trace  ",
@@ -52,13 +80,6 @@ gen_error_t* gen_log(
     };
 
     // [context         ][level  ] message
-    // [ + GEN_LOG_MAXIMUM_CONTEXT_LENGTH + ][ + 7 ("warning") + ] + 1
-    // GEN_LOG_MAXIMUM_CONTEXT_LENGTH + 12
-
-    char buf[
-            GEN_LOG_MAXIMUM_FORMATTED_LENGTH +
-            (GEN_LOG_MAXIMUM_CONTEXT_LENGTH + 12) + 1] = {0};
-
     gen_size_t context_pad = GEN_LOG_MAXIMUM_CONTEXT_LENGTH;
     for(gen_size_t i = 0; context[i]; ++i) {
         context_pad--;
@@ -70,12 +91,412 @@ gen_error_t* gen_log(
         }
     }
 
-    error = gen_format(
-                buf, GEN_NULL, sizeof(buf), "[%t%cz][%t] %t",
-                context, ' ', context_pad, levels[level], message);
+    return gen_string_builder_format(
+            line, "[%t%cz][%t] ", context, ' ', context_pad, levels[level]);
+}
+
+typedef struct {
+    gen_bool_t lock;
+    const char* format;
+    // The earliest time the bucket would be full again, in monotonic
+    // nanoseconds. Tracking this instead of a token count keeps refilling to a
+    // single comparison.
+    gen_uint64_t refilled;
+    gen_size_t suppressed;
+} gen_log_internal_site_t;
+
+static gen_log_internal_site_t
+        gen_log_internal_sites[GEN_LOG_RATE_LIMIT_SITES];
+static gen_size_t gen_log_internal_evicted = 0;
+
+static gen_uint64_t gen_log_internal_rate = GEN_LOG_RATE_LIMIT_PER_SECOND;
+static gen_uint64_t gen_log_internal_burst = GEN_LOG_RATE_LIMIT_BURST;
+
+gen_error_t* gen_log_set_rate_limit(
+        const gen_uint64_t per_second, const gen_uint64_t burst) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(per_second && !burst) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`burst` was 0 with rate limiting enabled");
+    }
+
+    __atomic_store_n(&gen_log_internal_burst, burst, __ATOMIC_RELAXED);
+    __atomic_store_n(&gen_log_internal_rate, per_second, __ATOMIC_RELAXED);
+
+    return GEN_NULL;
+}
+
+// `out_suppressed` receives how many messages the call site has had
+// suppressed since they were last reported, including this one.
+static gen_bool_t gen_log_internal_admit(
+        const char* const restrict format, const gen_uint64_t now,
+        gen_size_t* const restrict out_suppressed) {
+
+    *out_suppressed = 0;
+
+    const gen_uint64_t rate =
+            __atomic_load_n(&gen_log_internal_rate, __ATOMIC_RELAXED);
+    if(!rate) return gen_true;
+
+    const gen_uint64_t burst =
+            __atomic_load_n(&gen_log_internal_burst, __ATOMIC_RELAXED);
+
+    // Format strings are almost always literals, so their address identifies
+    // the call site without reading them.
+    const gen_uint64_t hash =
+            ((gen_uintptr_t) format * 0x9E3779B97F4A7C15ull) >> 32;
+    gen_log_internal_site_t* const site =
+            &gen_log_internal_sites[hash % GEN_LOG_RATE_LIMIT_SITES];
+
+    while(__atomic_test_and_set(&site->lock, __ATOMIC_ACQUIRE));
+
+    if(site->format != format) {
+        // Colliding call sites take the slot over, and whatever the previous
+        // one had suppressed is reported without attribution.
+        __atomic_add_fetch(
+                &gen_log_internal_evicted, site->suppressed, __ATOMIC_RELAXED);
+
+        site->format = format;
+        site->refilled = now;
+        site->suppressed = 0;
+    }
+
+    const gen_uint64_t interval = GEN_TIME_NANOSECONDS_PER_SECOND / rate;
+    const gen_uint64_t refilled = GEN_MAXIMUM(site->refilled, now);
+
+    const gen_bool_t admitted = refilled - now < burst * interval;
+    if(admitted) site->refilled = refilled + interval;
+    else *out_suppressed = ++site->suppressed;
+
+    __atomic_clear(&site->lock, __ATOMIC_RELEASE);
+
+    return admitted;
+}
+
+// Suppressed messages are never formatted, so the recorder gets a marker
+// naming the call site instead. Markers are only left as the count doubles
+// so that a storm can't flush everything before it out of the ring.
+static void gen_log_internal_record_suppressed(
+        const char* const restrict format, const gen_size_t suppressed) {
+
+    if(suppressed & (suppressed - 1)) return;
+
+    char marker[GEN_RECORDER_RECORD_LENGTH];
+    gen_size_t length = 0;
+    if(gen_format(
+            marker, &length, sizeof(marker),
+            "Suppressed %uz messages from `%t`", suppressed, format)) {
+
+        return;
+    }
+
+    gen_recorder_record(marker, GEN_MINIMUM(length, sizeof(marker)));
+}
+
+static gen_stream_writer_t* gen_log_internal_target = GEN_NULL;
+static gen_bool_t gen_log_internal_target_lock = gen_false;
+
+// The state below is guarded by the target lock.
+static gen_uint64_t gen_log_internal_last_hash = 0;
+static gen_size_t gen_log_internal_last_length = 0;
+static gen_log_level_t gen_log_internal_last_level = GEN_LOG_LEVEL_TRACE;
+static gen_size_t gen_log_internal_repeats = 0;
+static gen_uint64_t gen_log_internal_last_report = 0;
+
+static void gen_log_internal_lock(void) {
+    while(__atomic_test_and_set(
+            &gen_log_internal_target_lock, __ATOMIC_ACQUIRE));
+}
+
+static void gen_log_internal_unlock(void) {
+    __atomic_clear(&gen_log_internal_target_lock, __ATOMIC_RELEASE);
+}
+
+// Defined below alongside the reporting it drives.
+static gen_error_t* gen_log_internal_output(
+        const gen_log_level_t level, const char* const restrict line,
+        const gen_size_t length, const gen_uint64_t hash,
+        const gen_size_t hashed_length, const gen_uint64_t now);
+
+GEN_BACKENDS_PROC(terminal_write, void)
+gen_error_t* gen_log(
+        const gen_log_level_t level, const char* const restrict context,
+        const char* const restrict format, ...) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!context) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`context` was `GEN_NULL`");
+    }
+
+    if(!format) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`format` was `GEN_NULL`");
+    }
+
+    gen_metrics_internal_count_log(level);
+
+    gen_uint64_t now = 0;
+    error = gen_time_get_monotonic(&now);
     if(error) return error;
 
-    gen_backends_terminal_write(buf);
+    // Rate limiting is decided before formatting so that a storm costs no
+    // more than a clock read and a bucket update per message.
+    gen_size_t suppressed = 0;
+    if(level < GEN_LOG_LEVEL_ERROR &&
+            !gen_log_internal_admit(format, now, &suppressed)) {
+
+        gen_log_internal_record_suppressed(format, suppressed);
+        return GEN_NULL;
+    }
+
+    GEN_VARIADIC_LIST_AUTO gen_variadic_list_t list;
+    gen_variadic_list_start(list, format);
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    GEN_STRING_BUILDER_AUTO gen_string_builder_t line = {0};
+    error = gen_string_builder_create(&allocator, &line);
+    if(error) return error;
+
+    gen_size_t timestamp_length = 0;
+    error = gen_log_internal_compose(
+            &line, now, level, context, &timestamp_length);
+    if(error) return error;
+
+    error = gen_string_builder_format_variadic_list(&line, format, list);
+    if(error) return error;
+
+    const char* const string = gen_string_builder_internal_data(&line);
+    gen_recorder_record(string, line.length);
+
+    // Duplicates are compared without the timestamp, which always differs.
+    const gen_size_t hashed_length = line.length - timestamp_length;
+    const gen_uint64_t hash = gen_hash_internal_compute(
+            string + timestamp_length, hashed_length, 0);
+
+    gen_log_internal_lock();
+    error = gen_log_internal_output(
+            level, string, line.length, hash, hashed_length, now);
+    gen_log_internal_unlock();
+
+    return error;
+}
+
+static gen_error_t* gen_log_internal_write_target(
+        gen_stream_writer_t* const restrict writer,
+        const gen_log_level_t level, const char* const restrict message,
+        const gen_size_t length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_stream_writer_write(writer, message, length);
+    if(error) return error;
+
+    error = gen_stream_writer_write(writer, "\n", 1);
+    if(error) return error;
+
+    if(level >= GEN_LOG_LEVEL_ERROR) return gen_stream_writer_flush(writer);
 
     return GEN_NULL;
 }
+
+static gen_error_t* gen_log_internal_emit(
+        const gen_log_level_t level, const char* const restrict line,
+        const gen_size_t length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(gen_log_internal_target) {
+        return gen_log_internal_write_target(
+                gen_log_internal_target, level, line, length);
+    }
+
+    gen_backends_terminal_write(line);
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_log_internal_emit_report(
+        const gen_uint64_t time, const gen_log_level_t level,
+        const char* const restrict format, ...) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    GEN_VARIADIC_LIST_AUTO gen_variadic_list_t list;
+    gen_variadic_list_start(list, format);
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    GEN_STRING_BUILDER_AUTO gen_string_builder_t line = {0};
+    error = gen_string_builder_create(&allocator, &line);
+    if(error) return error;
+
+    error = gen_log_internal_compose(
+            &line, time, level, "genlog", GEN_NULL);
+    if(error) return error;
+
+    error = gen_string_builder_format_variadic_list(&line, format, list);
+    if(error) return error;
+
+    const char* const string = gen_string_builder_internal_data(&line);
+    gen_recorder_record(string, line.length);
+
+    return gen_log_internal_emit(level, string, line.length);
+}
+
+static gen_error_t* gen_log_internal_report_repeats(const gen_uint64_t time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_size_t repeats = gen_log_internal_repeats;
+    if(!repeats) return GEN_NULL;
+
+    gen_log_internal_repeats = 0;
+
+    return gen_log_internal_emit_report(
+            time, gen_log_internal_last_level,
+            "Last message repeated %uz times", repeats);
+}
+
+static gen_error_t* gen_log_internal_report_suppressed(
+        const gen_uint64_t time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    for(gen_size_t i = 0; i < GEN_LOG_RATE_LIMIT_SITES; ++i) {
+        gen_log_internal_site_t* const site = &gen_log_internal_sites[i];
+
+        while(__atomic_test_and_set(&site->lock, __ATOMIC_ACQUIRE));
+        const char* const format = site->format;
+        const gen_size_t suppressed = site->suppressed;
+        site->suppressed = 0;
+        __atomic_clear(&site->lock, __ATOMIC_RELEASE);
+
+        if(!suppressed) continue;
+
+        error = gen_log_internal_emit_report(
+                time, GEN_LOG_LEVEL_WARNING,
+                "Suppressed %uz messages from `%t`", suppressed, format);
+        if(error) return error;
+    }
+
+    const gen_size_t evicted = __atomic_exchange_n(
+            &gen_log_internal_evicted, 0, __ATOMIC_RELAXED);
+    if(!evicted) return GEN_NULL;
+
+    return gen_log_internal_emit_report(
+            time, GEN_LOG_LEVEL_WARNING,
+            "Suppressed %uz messages from other call sites", evicted);
+}
+
+// Reports the counts of repeated and suppressed messages which have built up
+// since the last report.
+static gen_error_t* gen_log_internal_report_pending(const gen_uint64_t time) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_log_internal_report_repeats(time);
+    if(error) return error;
+
+    gen_log_internal_last_report = time;
+
+    return gen_log_internal_report_suppressed(time);
+}
+
+// Drops `line` if it repeats the previous one and reports suppression counts
+// when they are due, then writes whatever remains.
+static gen_error_t* gen_log_internal_output(
+        const gen_log_level_t level, const char* const restrict line,
+        const gen_size_t length, const gen_uint64_t hash,
+        const gen_size_t hashed_length, const gen_uint64_t now) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // Errors are always written so that a failure is never hidden behind a
+    // count.
+    const gen_bool_t repeated =
+            level < GEN_LOG_LEVEL_ERROR &&
+            hash == gen_log_internal_last_hash &&
+            hashed_length == gen_log_internal_last_length;
+
+    if(repeated) gen_log_internal_repeats++;
+
+    // Nothing runs after a fatal message aborts, so everything pending is
+    // reported ahead of it.
+    const gen_bool_t due =
+            level == GEN_LOG_LEVEL_FATAL ||
+            now - gen_log_internal_last_report >=
+            GEN_LOG_SUPPRESSION_REPORT_INTERVAL;
+
+    if(due) {
+        error = gen_log_internal_report_pending(now);
+        if(error) return error;
+    }
+    else if(!repeated) {
+        error = gen_log_internal_report_repeats(now);
+        if(error) return error;
+    }
+
+    if(repeated) return GEN_NULL;
+
+    gen_log_internal_last_hash = hash;
+    gen_log_internal_last_length = hashed_length;
+    gen_log_internal_last_level = level;
+
+    return gen_log_internal_emit(level, line, length);
+}
+
+gen_error_t* gen_log_set_target(gen_stream_writer_t* const restrict writer) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint64_t now = 0;
+    error = gen_time_get_monotonic(&now);
+    if(error) return error;
+
+    gen_log_internal_lock();
+
+    // Pending counts belong to the old target's stream of messages.
+    error = gen_log_internal_report_pending(now);
+
+    gen_log_internal_target = writer;
+    gen_log_internal_last_length = 0;
+
+    gen_log_internal_unlock();
+
+    return error;
+}
+
+// Counts from call sites which have gone quiet would otherwise never be
+// reported. Errors are ignored as there is no one left to return them to.
+GEN_FINALIZER static void gen_log_internal_finalize(void) {
+    gen_uint64_t now = 0;
+    if(gen_time_get_monotonic(&now)) return;
+
+    gen_log_internal_lock();
+
+    if(!gen_log_internal_report_pending(now) && gen_log_internal_target) {
+        gen_stream_writer_flush(gen_log_internal_target);
+    }
+
+    gen_log_internal_unlock();
+}
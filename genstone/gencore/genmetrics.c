@@ -0,0 +1,359 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genmetrics.h"
+#include "include/genformat.h"
+
+#include <genbackends.h>
+
+#define GEN_METRICS_INTERNAL_LOG_LEVELS (GEN_LOG_LEVEL_FATAL + 1)
+#define GEN_METRICS_INTERNAL_ERROR_TYPES (GEN_ERROR_DOES_NOT_MATCH + 1)
+
+static gen_metrics_region_t* gen_metrics_internal_region = GEN_NULL;
+static char gen_metrics_internal_name[GEN_METRICS_NAME_LENGTH] = {0};
+
+static gen_bool_t gen_metrics_internal_lock = gen_false;
+
+// Threads are spread over the shards in the order they first update a
+// metric. The index is stored plus one so that zero means unassigned.
+static gen_size_t gen_metrics_internal_next_shard = 0;
+static GEN_THREAD_LOCAL gen_size_t gen_metrics_internal_shard = 0;
+
+static gen_metric_t gen_metrics_internal_log[GEN_METRICS_INTERNAL_LOG_LEVELS];
+static gen_metric_t
+        gen_metrics_internal_errors[GEN_METRICS_INTERNAL_ERROR_TYPES];
+static gen_metric_t gen_metrics_internal_allocations;
+static gen_metric_t gen_metrics_internal_allocated_bytes;
+static gen_metric_t gen_metrics_internal_freed_bytes;
+
+static gen_uint64_t* gen_metrics_internal_get_values(
+        const gen_metric_t* const restrict metric) {
+
+    gen_metrics_region_t* const region =
+            __atomic_load_n(&gen_metrics_internal_region, __ATOMIC_ACQUIRE);
+    if(!region) return GEN_NULL;
+
+    if(metric->kind == GEN_METRICS_KIND_GAUGE) {
+        return &region->shards[0][metric->offset];
+    }
+
+    if(!gen_metrics_internal_shard) {
+        gen_metrics_internal_shard = 1 + __atomic_fetch_add(
+                &gen_metrics_internal_next_shard, 1, __ATOMIC_RELAXED) %
+                GEN_METRICS_SHARDS;
+    }
+
+    return &region->shards[gen_metrics_internal_shard - 1][metric->offset];
+}
+
+void gen_metrics_add(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value) {
+
+    gen_uint64_t* const values = gen_metrics_internal_get_values(metric);
+    if(values) __atomic_fetch_add(values, value, __ATOMIC_RELAXED);
+}
+
+void gen_metrics_subtract(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value) {
+
+    gen_uint64_t* const values = gen_metrics_internal_get_values(metric);
+    if(values) __atomic_fetch_sub(values, value, __ATOMIC_RELAXED);
+}
+
+void gen_metrics_set(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value) {
+
+    gen_uint64_t* const values = gen_metrics_internal_get_values(metric);
+    if(values) __atomic_store_n(values, value, __ATOMIC_RELAXED);
+}
+
+void gen_metrics_record(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value) {
+
+    gen_uint64_t* const values = gen_metrics_internal_get_values(metric);
+    if(!values) return;
+
+    const gen_size_t bucket =
+            value ? 64 - (gen_size_t) __builtin_clzll(value) : 0;
+
+    __atomic_fetch_add(&values[0], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&values[1], value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&values[2 + bucket], 1, __ATOMIC_RELAXED);
+}
+
+void gen_metrics_internal_count_log(const gen_log_level_t level) {
+    gen_metrics_add(&gen_metrics_internal_log[level], 1);
+}
+
+void gen_metrics_internal_count_error(const gen_error_type_t type) {
+    gen_metrics_add(&gen_metrics_internal_errors[type], 1);
+}
+
+void gen_metrics_internal_count_allocation(const gen_size_t bytes) {
+    gen_metrics_add(&gen_metrics_internal_allocations, 1);
+    gen_metrics_add(&gen_metrics_internal_allocated_bytes, bytes);
+}
+
+void gen_metrics_internal_count_free(const gen_size_t bytes) {
+    gen_metrics_add(&gen_metrics_internal_freed_bytes, bytes);
+}
+
+static gen_error_t* gen_metrics_internal_register(
+        gen_metrics_region_t* const restrict region,
+        const char* const restrict name, const gen_metrics_kind_t kind,
+        gen_metric_t* const restrict out_metric) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_size_t length = 0;
+    for(; name[length]; ++length);
+
+    if(length >= GEN_METRICS_NAME_LENGTH) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "Metric name `%t` exceeded maximum length of %uz", name,
+                (gen_size_t) GEN_METRICS_NAME_LENGTH - 1);
+    }
+
+    for(gen_size_t i = 0; i < region->count; ++i) {
+        const char* const existing = region->descriptors[i].name;
+
+        gen_size_t j = 0;
+        for(; j < length && existing[j] == name[j]; ++j);
+        if(j == length && !existing[j]) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_ALREADY_EXISTS, GEN_LINE_STRING,
+                    "Metric `%t` was already registered", name);
+        }
+    }
+
+    const gen_size_t values =
+            kind == GEN_METRICS_KIND_HISTOGRAM ?
+            GEN_METRICS_HISTOGRAM_VALUES : 1;
+
+    if(region->count >= GEN_METRICS_MAXIMUM ||
+       region->used + values > GEN_METRICS_SHARD_VALUES) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_SPACE, GEN_LINE_STRING,
+                "No space left in metrics region for `%t`", name);
+    }
+
+    gen_metrics_descriptor_t* const descriptor =
+            &region->descriptors[region->count];
+
+    for(gen_size_t i = 0; i < length; ++i) descriptor->name[i] = name[i];
+    descriptor->kind = kind;
+    descriptor->offset = region->used;
+
+    region->used += values;
+    __atomic_store_n(&region->count, region->count + 1, __ATOMIC_RELEASE);
+
+    *out_metric = (gen_metric_t) { kind, descriptor->offset };
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_metrics_internal_register_builtins(
+        gen_metrics_region_t* const restrict region) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const char* const levels[] = {
+        [GEN_LOG_LEVEL_TRACE] = "log.trace",
+        [GEN_LOG_LEVEL_DEBUG] = "log.debug",
+        [GEN_LOG_LEVEL_INFO] = "log.info",
+        [GEN_LOG_LEVEL_WARNING] = "log.warning",
+        [GEN_LOG_LEVEL_ERROR] = "log.error",
+        [GEN_LOG_LEVEL_FATAL] = "log.fatal"
+    };
+
+    for(gen_size_t i = 0; i < GEN_METRICS_INTERNAL_LOG_LEVELS; ++i) {
+        error = gen_metrics_internal_register(
+                region, levels[i], GEN_METRICS_KIND_COUNTER,
+                &gen_metrics_internal_log[i]);
+        if(error) return error;
+    }
+
+    for(gen_size_t i = 0; i < GEN_METRICS_INTERNAL_ERROR_TYPES; ++i) {
+        char name[GEN_METRICS_NAME_LENGTH] = {0};
+        error = gen_format(
+                name, GEN_NULL, sizeof(name) - 1, "error.%t",
+                gen_error_type_name((gen_error_type_t) i));
+        if(error) return error;
+
+        error = gen_metrics_internal_register(
+                region, name, GEN_METRICS_KIND_COUNTER,
+                &gen_metrics_internal_errors[i]);
+        if(error) return error;
+    }
+
+    error = gen_metrics_internal_register(
+            region, "allocator.allocations", GEN_METRICS_KIND_COUNTER,
+            &gen_metrics_internal_allocations);
+    if(error) return error;
+
+    error = gen_metrics_internal_register(
+            region, "allocator.allocated_bytes", GEN_METRICS_KIND_COUNTER,
+            &gen_metrics_internal_allocated_bytes);
+    if(error) return error;
+
+    return gen_metrics_internal_register(
+            region, "allocator.freed_bytes", GEN_METRICS_KIND_COUNTER,
+            &gen_metrics_internal_freed_bytes);
+}
+
+static void gen_metrics_internal_acquire(void) {
+    while(__atomic_test_and_set(&gen_metrics_internal_lock, __ATOMIC_ACQUIRE));
+}
+
+static void gen_metrics_internal_release(void) {
+    __atomic_clear(&gen_metrics_internal_lock, __ATOMIC_RELEASE);
+}
+
+GEN_BACKENDS_PROC(metrics_map, gen_error_t*)
+GEN_BACKENDS_PROC(metrics_unmap, gen_error_t*)
+
+static gen_error_t* gen_metrics_internal_create(
+        const char* const restrict name) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(gen_metrics_internal_region) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_ALREADY_EXISTS, GEN_LINE_STRING,
+                "Metrics region was already created");
+    }
+
+    gen_size_t length = 0;
+    for(; name[length]; ++length);
+
+    if(length >= GEN_METRICS_NAME_LENGTH) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "Metrics region name `%t` exceeded maximum length of %uz",
+                name, (gen_size_t) GEN_METRICS_NAME_LENGTH - 1);
+    }
+
+    // The region starts out zeroed.
+    void* mapping = GEN_NULL;
+    error = gen_backends_metrics_map(
+            name, sizeof(gen_metrics_region_t), &mapping);
+    if(error) return error;
+
+    gen_metrics_region_t* const region = mapping;
+
+    region->magic = GEN_METRICS_MAGIC;
+
+    error = gen_metrics_internal_register_builtins(region);
+    if(error) {
+        gen_backends_metrics_unmap(name, region, sizeof(*region));
+        return error;
+    }
+
+    for(gen_size_t i = 0; i <= length; ++i) {
+        gen_metrics_internal_name[i] = name[i];
+    }
+
+    __atomic_store_n(&gen_metrics_internal_region, region, __ATOMIC_RELEASE);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_metrics_create(const char* const restrict name) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!name) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`name` was `GEN_NULL`");
+    }
+
+    // Backends use the name as a file name, so it must not be able to reach
+    // outside the directory holding regions.
+    gen_bool_t dots = gen_true;
+    gen_size_t length = 0;
+    for(; name[length]; ++length) {
+        if(name[length] == '/') {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "`name` `%t` contained `/`", name);
+        }
+
+        if(name[length] != '.') dots = gen_false;
+    }
+
+    if(!length || (dots && length <= 2)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`name` `%t` was not a valid file name", name);
+    }
+
+    gen_metrics_internal_acquire();
+    error = gen_metrics_internal_create(name);
+    gen_metrics_internal_release();
+
+    return error;
+}
+
+gen_error_t* gen_metrics_destroy(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_metrics_internal_acquire();
+
+    gen_metrics_region_t* const region = gen_metrics_internal_region;
+    __atomic_store_n(&gen_metrics_internal_region, GEN_NULL, __ATOMIC_RELEASE);
+
+    if(!region) {
+        gen_metrics_internal_release();
+        return GEN_NULL;
+    }
+
+    error = gen_backends_metrics_unmap(
+            gen_metrics_internal_name, region, sizeof(*region));
+
+    gen_metrics_internal_release();
+
+    return error;
+}
+
+gen_error_t* gen_metrics_register(
+        const char* const restrict name, const gen_metrics_kind_t kind,
+        gen_metric_t* const restrict out_metric) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!name) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`name` was `GEN_NULL`");
+    }
+
+    if(!out_metric) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_metric` was `GEN_NULL`");
+    }
+
+    gen_metrics_internal_acquire();
+
+    if(gen_metrics_internal_region) {
+        error = gen_metrics_internal_register(
+                gen_metrics_internal_region, name, kind, out_metric);
+    }
+    else {
+        error = gen_error_attach_backtrace(
+                GEN_ERROR_BAD_OPERATION, GEN_LINE_STRING,
+                "Metrics region has not been created");
+    }
+
+    gen_metrics_internal_release();
+
+    return error;
+}
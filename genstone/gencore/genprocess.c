@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genprocess.h"
+
+#include <genbackends.h>
+
+GEN_BACKENDS_PROC(process_fork, gen_error_t*)
+gen_error_t* gen_process_fork(
+        const gen_process_proc_t proc, void* const restrict user_data,
+        gen_process_t* const restrict out_process) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!proc) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`proc` was `GEN_NULL`");
+    }
+
+    if(!out_process) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_process` was `GEN_NULL`");
+    }
+
+    *out_process = (gen_process_t) {0};
+    out_process->output.access = GEN_FILE_ACCESS_READ;
+
+    return gen_backends_process_fork(proc, user_data, out_process);
+}
+
+GEN_BACKENDS_PROC(process_kill, gen_error_t*)
+gen_error_t* gen_process_kill(const gen_process_t* const restrict process) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!process) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`process` was `GEN_NULL`");
+    }
+
+    return gen_backends_process_kill(process);
+}
+
+GEN_BACKENDS_PROC(process_wait, gen_error_t*)
+gen_error_t* gen_process_wait(
+        gen_process_t* const restrict process,
+        gen_process_status_t* const restrict out_status) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!process) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`process` was `GEN_NULL`");
+    }
+
+    if(!out_status) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_status` was `GEN_NULL`");
+    }
+
+    *out_status = (gen_process_status_t) {0};
+
+    error = gen_backends_process_wait(process, out_status);
+    if(error) return error;
+
+    error = gen_file_close(&process->output);
+    if(error) return error;
+
+    *process = (gen_process_t) {0};
+
+    return GEN_NULL;
+}
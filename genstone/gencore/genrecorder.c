@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genrecorder.h"
+
+#include <genbackends.h>
+
+typedef struct {
+    gen_size_t length;
+    char text[GEN_RECORDER_RECORD_LENGTH];
+} gen_recorder_record_t;
+
+// Only ever written by its own thread, so the only reader which can race a
+// write is a signal handler interrupting it on that same thread.
+typedef struct {
+    gen_size_t count;
+    gen_recorder_record_t records[GEN_RECORDER_CAPACITY];
+} gen_recorder_ring_t;
+
+static GEN_THREAD_LOCAL gen_recorder_ring_t gen_recorder_internal_ring = {0};
+
+// Resolved ahead of time so that dumping never has to call into tooling.
+static gen_file_t gen_recorder_internal_output = {0};
+
+GEN_INITIALIZER static void gen_recorder_internal_initialize(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_file_get_standard(
+            GEN_FILE_STANDARD_ERROR, &gen_recorder_internal_output);
+    if(error) gen_abort();
+}
+
+void gen_recorder_record(
+        const char* const restrict text, const gen_size_t length) {
+
+    gen_recorder_ring_t* const ring = &gen_recorder_internal_ring;
+    gen_recorder_record_t* const record =
+            &ring->records[ring->count % GEN_RECORDER_CAPACITY];
+
+    record->length = GEN_MINIMUM(length, GEN_RECORDER_RECORD_LENGTH);
+    for(gen_size_t i = 0; i < record->length; ++i) record->text[i] = text[i];
+
+    // Keeps a dump from a signal handler from seeing the count before the
+    // record it covers.
+    __atomic_signal_fence(__ATOMIC_RELEASE);
+    ++ring->count;
+}
+
+gen_error_t* gen_recorder_set_output(const gen_file_t* const restrict file) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(file) {
+        gen_recorder_internal_output = *file;
+        return GEN_NULL;
+    }
+
+    return gen_file_get_standard(
+            GEN_FILE_STANDARD_ERROR, &gen_recorder_internal_output);
+}
+
+GEN_BACKENDS_PROC(recorder_write, void)
+static void gen_recorder_internal_write(
+        const gen_file_t* const restrict file, const char* const restrict text,
+        const gen_size_t length) {
+
+    gen_backends_recorder_write(file, text, length);
+}
+
+static void gen_recorder_internal_write_string(
+        const gen_file_t* const restrict file,
+        const char* const restrict string) {
+
+    gen_size_t length = 0;
+    if(string) for(; string[length]; ++length);
+
+    gen_recorder_internal_write(file, string, length);
+}
+
+// Nothing here may allocate, lock or push tooling frames since we may be
+// inside a signal handler or a failing tooling stack.
+void gen_recorder_dump(void) {
+    const gen_file_t file = gen_recorder_internal_output;
+
+    const gen_recorder_ring_t* const ring = &gen_recorder_internal_ring;
+    const gen_size_t count = ring->count;
+    __atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+    const gen_size_t start =
+            count > GEN_RECORDER_CAPACITY ? count - GEN_RECORDER_CAPACITY : 0;
+
+    gen_recorder_internal_write_string(&file, "Flight recorder:\n");
+    for(gen_size_t i = start; i < count; ++i) {
+        const gen_recorder_record_t* const record =
+                &ring->records[i % GEN_RECORDER_CAPACITY];
+
+        gen_recorder_internal_write_string(&file, "    ");
+        gen_recorder_internal_write(&file, record->text, record->length);
+        gen_recorder_internal_write_string(&file, "\n");
+    }
+
+    gen_backtrace_t backtrace;
+    gen_size_t length = 0;
+    gen_tooling_get_backtrace(backtrace, &length);
+
+    gen_recorder_internal_write_string(&file, "Backtrace:\n");
+    for(gen_size_t i = length; i--;) {
+        gen_recorder_internal_write_string(&file, "    ");
+        gen_recorder_internal_write_string(&file, backtrace[i].function);
+        gen_recorder_internal_write_string(&file, " (");
+        gen_recorder_internal_write_string(&file, backtrace[i].file);
+        gen_recorder_internal_write_string(&file, ")\n");
+    }
+}
+
+GEN_BACKENDS_PROC(recorder_install_signal_handlers, gen_error_t*)
+gen_error_t* gen_recorder_install_signal_handlers(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    return gen_backends_recorder_install_signal_handlers();
+}
@@ -0,0 +1,882 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/gensort.h"
+#include "include/genthread.h"
+
+// How many records ahead the radix scatter fetches its destinations.
+#ifndef GEN_SORT_PREFETCH_DISTANCE
+#define GEN_SORT_PREFETCH_DISTANCE 8
+#endif
+
+#define GEN_SORT_INTERNAL_DIGITS 8
+#define GEN_SORT_INTERNAL_BUCKETS 256
+
+typedef struct {
+    gen_size_t stride;
+    gen_size_t key_offset;
+    gen_size_t key_size;
+} gen_sort_internal_layout_t;
+
+typedef struct {
+    gen_size_t size;
+    gen_sort_less_t less;
+    void* user_data;
+} gen_sort_internal_comparison_t;
+
+static GEN_FORCE_INLINE void gen_sort_internal_move(
+        void* const restrict to, const void* const restrict from,
+        const gen_size_t size) {
+
+    // Common sizes become single loads and stores rather than a call.
+    switch(size) {
+        case 4: __builtin_memcpy(to, from, 4); break;
+        case 8: __builtin_memcpy(to, from, 8); break;
+        case 16: __builtin_memcpy(to, from, 16); break;
+        default: __builtin_memcpy(to, from, size); break;
+    }
+}
+
+static GEN_FORCE_INLINE gen_uint64_t gen_sort_internal_key(
+        const gen_uint8_t* const restrict record,
+        const gen_sort_internal_layout_t* const restrict layout) {
+
+    const gen_uint8_t* const key = record + layout->key_offset;
+
+    switch(layout->key_size) {
+        case 1: return *key;
+        case 2: {
+            gen_uint16_t value;
+            __builtin_memcpy(&value, key, sizeof(value));
+            return value;
+        }
+        case 4: {
+            gen_uint32_t value;
+            __builtin_memcpy(&value, key, sizeof(value));
+            return value;
+        }
+        default: {
+            gen_uint64_t value;
+            __builtin_memcpy(&value, key, sizeof(value));
+            return value;
+        }
+    }
+}
+
+static GEN_FORCE_INLINE gen_size_t gen_sort_internal_bucket(
+        const gen_uint64_t key, const gen_size_t digit) {
+
+    return (gen_size_t) (key >> (digit * 8)) & 0xFF;
+}
+
+// Tasks are claimed from a shared counter so that threads which finish early
+// take on more of the work.
+typedef void (*gen_sort_internal_task_t)(
+        void* const restrict context, const gen_size_t index);
+
+typedef struct {
+    gen_sort_internal_task_t task;
+    void* context;
+    gen_size_t count;
+    gen_size_t next;
+} gen_sort_internal_queue_t;
+
+static gen_error_t* gen_sort_internal_worker(void* const passthrough) {
+    gen_sort_internal_queue_t* const queue = passthrough;
+
+    while(gen_true) {
+        const gen_size_t index =
+                __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED);
+        if(index >= queue->count) break;
+
+        queue->task(queue->context, index);
+    }
+
+    return GEN_NULL;
+}
+
+// Works through `queue` on up to `thread_count` threads, one of which is the
+// calling thread, and returns once every task has finished.
+static gen_error_t* gen_sort_internal_run(
+        gen_sort_internal_queue_t* const restrict queue,
+        gen_thread_t* const restrict threads, const gen_size_t thread_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    queue->next = 0;
+
+    const gen_size_t helpers =
+            GEN_MINIMUM(thread_count, GEN_MAXIMUM(queue->count, 1)) - 1;
+
+    // Threads which fail to start just leave more work for the others.
+    gen_size_t started = 0;
+    while(started < helpers) {
+        if(gen_thread_create(
+                gen_sort_internal_worker, queue, &threads[started])) break;
+        ++started;
+    }
+
+    gen_sort_internal_worker(queue);
+
+    // Every thread is joined before reporting a failure as they may still be
+    // working on memory the caller is about to free.
+    gen_bool_t failed = gen_false;
+    for(gen_size_t i = 0; i < started; ++i) {
+        gen_bool_t thread_failed = gen_false;
+        failed = !!gen_thread_join(&threads[i], &thread_failed) || failed;
+    }
+
+    if(failed) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                "Failed to join sorting threads");
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_sort_internal_thread_count(
+        const gen_size_t requested, const gen_size_t count,
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_size_t maximum = count / GEN_SORT_PARALLEL_MINIMUM;
+
+    gen_size_t threads = requested;
+    if(!threads && maximum > 1) {
+        error = gen_thread_get_processor_count(&threads);
+        if(error) return error;
+    }
+
+    *out_count = GEN_MAXIMUM(GEN_MINIMUM(threads, maximum), 1);
+
+    return GEN_NULL;
+}
+
+static void gen_sort_internal_radix_histogram(
+        const gen_uint8_t* const restrict records, const gen_size_t count,
+        const gen_sort_internal_layout_t* const restrict layout,
+        const gen_size_t digits,
+        gen_size_t (* const restrict histograms)[GEN_SORT_INTERNAL_BUCKETS]) {
+
+    for(gen_size_t d = 0; d < digits; ++d) {
+        for(gen_size_t b = 0; b < GEN_SORT_INTERNAL_BUCKETS; ++b) {
+            histograms[d][b] = 0;
+        }
+    }
+
+    // Every digit is counted in the one pass over the records.
+    for(gen_size_t i = 0; i < count; ++i) {
+        const gen_uint64_t key =
+                gen_sort_internal_key(records + i * layout->stride, layout);
+
+        for(gen_size_t d = 0; d < digits; ++d) {
+            ++histograms[d][gen_sort_internal_bucket(key, d)];
+        }
+    }
+}
+
+// Moves each record to the next free slot of its bucket, `offsets` giving
+// where each bucket starts in `to`.
+static void gen_sort_internal_radix_scatter(
+        const gen_uint8_t* const restrict from, gen_uint8_t* const restrict to,
+        const gen_size_t count,
+        const gen_sort_internal_layout_t* const restrict layout,
+        const gen_size_t digit, const gen_size_t* const restrict offsets) {
+
+    const gen_size_t stride = layout->stride;
+
+    gen_uint8_t* heads[GEN_SORT_INTERNAL_BUCKETS];
+    for(gen_size_t b = 0; b < GEN_SORT_INTERNAL_BUCKETS; ++b) {
+        heads[b] = to + offsets[b] * stride;
+    }
+
+    for(gen_size_t i = 0; i < count; ++i) {
+        // Writes land in up to 256 places at once which is more streams than
+        // the hardware prefetcher follows, so they are fetched by hand.
+        if(GEN_LIKELY(i + GEN_SORT_PREFETCH_DISTANCE < count)) {
+            const gen_uint64_t ahead = gen_sort_internal_key(
+                    from + (i + GEN_SORT_PREFETCH_DISTANCE) * stride, layout);
+            __builtin_prefetch(
+                    heads[gen_sort_internal_bucket(ahead, digit)], 1);
+        }
+
+        const gen_uint8_t* const record = from + i * stride;
+        const gen_size_t bucket = gen_sort_internal_bucket(
+                gen_sort_internal_key(record, layout), digit);
+
+        gen_sort_internal_move(heads[bucket], record, stride);
+        heads[bucket] += stride;
+    }
+}
+
+static void gen_sort_internal_radix_insertion(
+        gen_uint8_t* const restrict records, const gen_size_t count,
+        const gen_sort_internal_layout_t* const restrict layout,
+        gen_uint8_t* const restrict temporary) {
+
+    const gen_size_t stride = layout->stride;
+
+    for(gen_size_t i = 1; i < count; ++i) {
+        const gen_uint64_t key =
+                gen_sort_internal_key(records + i * stride, layout);
+
+        gen_size_t j = i;
+        while(j && gen_sort_internal_key(
+                records + (j - 1) * stride, layout) > key) --j;
+        if(j == i) continue;
+
+        gen_sort_internal_move(temporary, records + i * stride, stride);
+        for(gen_size_t k = i; k > j; --k) {
+            gen_sort_internal_move(
+                    records + k * stride, records + (k - 1) * stride, stride);
+        }
+        gen_sort_internal_move(records + j * stride, temporary, stride);
+    }
+}
+
+// Sorts by the lowest `digits` bytes of the key, passing the records back and
+// forth between `records` and `scratch`. Returns whichever of the two ends up
+// holding the result.
+static gen_uint8_t* gen_sort_internal_radix_lsd(
+        gen_uint8_t* const records, gen_uint8_t* const scratch,
+        const gen_size_t count,
+        const gen_sort_internal_layout_t* const restrict layout,
+        const gen_size_t digits) {
+
+    if(count < GEN_SORT_INSERTION_THRESHOLD) {
+        gen_sort_internal_radix_insertion(records, count, layout, scratch);
+        return records;
+    }
+
+    gen_size_t histograms[GEN_SORT_INTERNAL_DIGITS][GEN_SORT_INTERNAL_BUCKETS];
+    gen_sort_internal_radix_histogram(
+            records, count, layout, digits, histograms);
+
+    const gen_uint64_t first = gen_sort_internal_key(records, layout);
+
+    gen_uint8_t* from = records;
+    gen_uint8_t* to = scratch;
+    for(gen_size_t d = 0; d < digits; ++d) {
+        // A pass where every record shares the digit would move nothing.
+        const gen_size_t* const histogram = histograms[d];
+        if(histogram[gen_sort_internal_bucket(first, d)] == count) continue;
+
+        gen_size_t offsets[GEN_SORT_INTERNAL_BUCKETS];
+        gen_size_t offset = 0;
+        for(gen_size_t b = 0; b < GEN_SORT_INTERNAL_BUCKETS; ++b) {
+            offsets[b] = offset;
+            offset += histogram[b];
+        }
+
+        gen_sort_internal_radix_scatter(from, to, count, layout, d, offsets);
+
+        gen_uint8_t* const swap = from;
+        from = to;
+        to = swap;
+    }
+
+    return from;
+}
+
+// The parallel radix sort distributes records across buckets by their most
+// significant differing digit, with each thread scattering its own chunk of
+// the array, then sorts the buckets independently on the remaining digits.
+typedef struct {
+    gen_uint8_t* records;
+    gen_uint8_t* scratch;
+    gen_size_t count;
+    gen_sort_internal_layout_t layout;
+
+    gen_size_t chunks;
+    gen_size_t chunk_length;
+    // `key_size` histograms per chunk.
+    gen_size_t (*histograms)[GEN_SORT_INTERNAL_BUCKETS];
+    // Where each chunk's share of each bucket starts.
+    gen_size_t (*offsets)[GEN_SORT_INTERNAL_BUCKETS];
+
+    gen_size_t digit;
+    gen_size_t starts[GEN_SORT_INTERNAL_BUCKETS + 1];
+    // Non-empty buckets, largest first so that the long tail of small buckets
+    // evens out the finishing times of threads.
+    gen_size_t order[GEN_SORT_INTERNAL_BUCKETS];
+    gen_size_t order_length;
+} gen_sort_internal_radix_t;
+
+static void gen_sort_internal_radix_histogram_task(
+        void* const restrict context, const gen_size_t index) {
+
+    gen_sort_internal_radix_t* const radix = context;
+
+    const gen_size_t begin = index * radix->chunk_length;
+    const gen_size_t end =
+            GEN_MINIMUM(begin + radix->chunk_length, radix->count);
+
+    gen_sort_internal_radix_histogram(
+            radix->records + begin * radix->layout.stride, end - begin,
+            &radix->layout, radix->layout.key_size,
+            radix->histograms + index * radix->layout.key_size);
+}
+
+static void gen_sort_internal_radix_scatter_task(
+        void* const restrict context, const gen_size_t index) {
+
+    gen_sort_internal_radix_t* const radix = context;
+
+    const gen_size_t begin = index * radix->chunk_length;
+    const gen_size_t end =
+            GEN_MINIMUM(begin + radix->chunk_length, radix->count);
+
+    gen_sort_internal_radix_scatter(
+            radix->records + begin * radix->layout.stride, radix->scratch,
+            end - begin, &radix->layout, radix->digit, radix->offsets[index]);
+}
+
+static void gen_sort_internal_radix_bucket_task(
+        void* const restrict context, const gen_size_t index) {
+
+    gen_sort_internal_radix_t* const radix = context;
+
+    const gen_size_t bucket = radix->order[index];
+    const gen_size_t stride = radix->layout.stride;
+    const gen_size_t begin = radix->starts[bucket];
+    const gen_size_t count = radix->starts[bucket + 1] - begin;
+
+    gen_uint8_t* const records = radix->records + begin * stride;
+    gen_uint8_t* const scratch = radix->scratch + begin * stride;
+
+    gen_uint8_t* const result = gen_sort_internal_radix_lsd(
+            scratch, records, count, &radix->layout, radix->digit);
+    if(result != records) __builtin_memcpy(records, result, count * stride);
+}
+
+static gen_error_t* gen_sort_internal_radix_parallel(
+        gen_sort_internal_radix_t* const restrict radix,
+        gen_thread_t* const restrict threads, const gen_size_t thread_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_size_t key_size = radix->layout.key_size;
+
+    gen_sort_internal_queue_t queue = {
+        gen_sort_internal_radix_histogram_task, radix, radix->chunks, 0
+    };
+    error = gen_sort_internal_run(&queue, threads, thread_count);
+    if(error) return error;
+
+    gen_size_t totals[GEN_SORT_INTERNAL_DIGITS][GEN_SORT_INTERNAL_BUCKETS] =
+            {0};
+    for(gen_size_t c = 0; c < radix->chunks; ++c) {
+        for(gen_size_t d = 0; d < key_size; ++d) {
+            for(gen_size_t b = 0; b < GEN_SORT_INTERNAL_BUCKETS; ++b) {
+                totals[d][b] += radix->histograms[c * key_size + d][b];
+            }
+        }
+    }
+
+    // Splitting on the most significant digit which differs keeps small keys
+    // stored in wide fields from landing in a single bucket.
+    const gen_uint64_t first =
+            gen_sort_internal_key(radix->records, &radix->layout);
+
+    gen_size_t digit = key_size;
+    while(digit--) {
+        const gen_size_t bucket = gen_sort_internal_bucket(first, digit);
+        if(totals[digit][bucket] != radix->count) break;
+    }
+
+    // Every key is the same.
+    if(digit == GEN_SIZE_MAX) return GEN_NULL;
+
+    radix->digit = digit;
+
+    radix->starts[0] = 0;
+    for(gen_size_t b = 0; b < GEN_SORT_INTERNAL_BUCKETS; ++b) {
+        radix->starts[b + 1] = radix->starts[b] + totals[digit][b];
+
+        gen_size_t offset = radix->starts[b];
+        for(gen_size_t c = 0; c < radix->chunks; ++c) {
+            radix->offsets[c][b] = offset;
+            offset += radix->histograms[c * key_size + digit][b];
+        }
+    }
+
+    queue = (gen_sort_internal_queue_t) {
+        gen_sort_internal_radix_scatter_task, radix, radix->chunks, 0
+    };
+    error = gen_sort_internal_run(&queue, threads, thread_count);
+    if(error) return error;
+
+    radix->order_length = 0;
+    for(gen_size_t b = 0; b < GEN_SORT_INTERNAL_BUCKETS; ++b) {
+        const gen_size_t length = totals[digit][b];
+        if(!length) continue;
+
+        gen_size_t i = radix->order_length++;
+        for(; i && totals[digit][radix->order[i - 1]] < length; --i) {
+            radix->order[i] = radix->order[i - 1];
+        }
+        radix->order[i] = b;
+    }
+
+    // The remaining digits are below `digit`.
+    queue = (gen_sort_internal_queue_t) {
+        gen_sort_internal_radix_bucket_task, radix, radix->order_length, 0
+    };
+    error = gen_sort_internal_run(&queue, threads, thread_count);
+    if(error) return error;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_sort_radix(
+        void* const restrict records, const gen_size_t count,
+        const gen_size_t stride, const gen_size_t key_offset,
+        const gen_size_t key_size, const gen_size_t thread_count,
+        const gen_system_allocator_t* const restrict allocator) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!records && count) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`records` was `GEN_NULL`");
+    }
+
+    if(key_size != 1 && key_size != 2 && key_size != 4 && key_size != 8) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`key_size` %uz was not 1, 2, 4 or 8", key_size);
+    }
+
+    if(key_offset > stride || stride - key_offset < key_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_BOUNDS, GEN_LINE_STRING,
+                "Key at offset %uz of size %uz exceeded `stride` %uz",
+                key_offset, key_size, stride);
+    }
+
+    if(!allocator) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`allocator` was `GEN_NULL`");
+    }
+
+    if(count < 2) return GEN_NULL;
+
+    gen_size_t bytes = 0;
+    if(__builtin_mul_overflow(count, stride, &bytes)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "%uz records of %uz bytes exceeded the address space", count,
+                stride);
+    }
+
+    gen_size_t threads = 1;
+    error = gen_sort_internal_thread_count(thread_count, count, &threads);
+    if(error) return error;
+
+    gen_sort_internal_radix_t radix = {0};
+    radix.records = records;
+    radix.count = count;
+    radix.layout =
+            (gen_sort_internal_layout_t) { stride, key_offset, key_size };
+    radix.chunks = threads;
+    radix.chunk_length = (count + threads - 1) / threads;
+
+    // Bookkeeping for the parallel sort shares an allocation with the scratch
+    // space, ahead of it to keep its alignment.
+    const gen_size_t histograms = threads > 1 ? threads * key_size : 0;
+    const gen_size_t offsets = threads > 1 ? threads : 0;
+    const gen_size_t bookkeeping =
+            (histograms + offsets) * sizeof(*radix.histograms) +
+            (threads - 1) * sizeof(gen_thread_t);
+
+    if(bytes > GEN_SIZE_MAX - bookkeeping) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "%uz records of %uz bytes exceeded the address space", count,
+                stride);
+    }
+
+    void* const allocation = allocator->malloc(bookkeeping + bytes);
+    if(!allocation) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate %uz bytes of scratch space",
+                bookkeeping + bytes);
+    }
+
+    radix.histograms = allocation;
+    radix.offsets = radix.histograms + histograms;
+    gen_thread_t* const thread_storage = (void*) (radix.offsets + offsets);
+    radix.scratch = (void*) (thread_storage + threads - 1);
+
+    if(threads > 1) {
+        error = gen_sort_internal_radix_parallel(
+                &radix, thread_storage, threads);
+    }
+    else {
+        gen_uint8_t* const result = gen_sort_internal_radix_lsd(
+                radix.records, radix.scratch, count, &radix.layout, key_size);
+        if(result != radix.records) {
+            __builtin_memcpy(radix.records, result, bytes);
+        }
+    }
+
+    allocator->free(allocation);
+
+    return error;
+}
+
+static void gen_sort_internal_merge_insertion(
+        const gen_uint8_t* const restrict from, gen_uint8_t* const restrict to,
+        const gen_size_t count,
+        const gen_sort_internal_comparison_t* const restrict comparison) {
+
+    const gen_size_t size = comparison->size;
+
+    // `from` holds the same elements as `to`, so each can be inserted from
+    // there without keeping it aside while the sorted run is shifted up.
+    for(gen_size_t i = 1; i < count; ++i) {
+        const gen_uint8_t* const element = from + i * size;
+
+        gen_size_t j = i;
+        while(j && comparison->less(
+                element, to + (j - 1) * size, comparison->user_data)) {
+            gen_sort_internal_move(
+                    to + j * size, to + (j - 1) * size, size);
+            --j;
+        }
+
+        if(j != i) gen_sort_internal_move(to + j * size, element, size);
+    }
+}
+
+static void gen_sort_internal_merge_runs(
+        const gen_uint8_t* restrict left, gen_size_t left_count,
+        const gen_uint8_t* restrict right, gen_size_t right_count,
+        gen_uint8_t* restrict to,
+        const gen_sort_internal_comparison_t* const restrict comparison) {
+
+    const gen_size_t size = comparison->size;
+
+    // Ties go to the left to keep the sort stable.
+    while(left_count && right_count) {
+        if(comparison->less(right, left, comparison->user_data)) {
+            gen_sort_internal_move(to, right, size);
+            right += size;
+            --right_count;
+        }
+        else {
+            gen_sort_internal_move(to, left, size);
+            left += size;
+            --left_count;
+        }
+
+        to += size;
+    }
+
+    __builtin_memcpy(to, left, left_count * size);
+    __builtin_memcpy(to + left_count * size, right, right_count * size);
+}
+
+// Sorts `to`, which starts out holding the same elements as `from`, using
+// `from` as scratch space.
+static void gen_sort_internal_merge_split(
+        gen_uint8_t* const from, gen_uint8_t* const to, const gen_size_t count,
+        const gen_sort_internal_comparison_t* const restrict comparison) {
+
+    if(count <= GEN_SORT_INSERTION_THRESHOLD) {
+        gen_sort_internal_merge_insertion(from, to, count, comparison);
+        return;
+    }
+
+    const gen_size_t size = comparison->size;
+    const gen_size_t half = count / 2;
+    gen_uint8_t* const middle = from + half * size;
+
+    // The halves are sorted into `from` so that they merge into `to`.
+    gen_sort_internal_merge_split(to, from, half, comparison);
+    gen_sort_internal_merge_split(
+            to + half * size, middle, count - half, comparison);
+
+    // Runs which are already in order only need copying across.
+    if(!comparison->less(middle, middle - size, comparison->user_data)) {
+        __builtin_memcpy(to, from, count * size);
+        return;
+    }
+
+    gen_sort_internal_merge_runs(
+            from, half, middle, count - half, to, comparison);
+}
+
+// The parallel merge sort sorts a chunk of the array per thread, then merges
+// pairs of runs until one is left. Each merge is cut into as many pieces as
+// the pair's share of the threads, found by searching for where each piece's
+// output starts.
+typedef struct {
+    gen_size_t left;
+    gen_size_t left_count;
+    gen_size_t right_count;
+    // The piece of the merged output this task produces.
+    gen_size_t begin;
+    gen_size_t end;
+} gen_sort_internal_merge_task_t;
+
+typedef struct {
+    gen_uint8_t* elements;
+    gen_uint8_t* scratch;
+    gen_size_t count;
+    gen_sort_internal_comparison_t comparison;
+
+    gen_size_t chunk_length;
+
+    gen_uint8_t* from;
+    gen_uint8_t* to;
+    gen_sort_internal_merge_task_t* tasks;
+} gen_sort_internal_merge_t;
+
+static void gen_sort_internal_merge_chunk_task(
+        void* const restrict context, const gen_size_t index) {
+
+    gen_sort_internal_merge_t* const merge = context;
+
+    const gen_size_t size = merge->comparison.size;
+    const gen_size_t begin = index * merge->chunk_length;
+    const gen_size_t end =
+            GEN_MINIMUM(begin + merge->chunk_length, merge->count);
+
+    gen_uint8_t* const elements = merge->elements + begin * size;
+    gen_uint8_t* const scratch = merge->scratch + begin * size;
+
+    __builtin_memcpy(scratch, elements, (end - begin) * size);
+    gen_sort_internal_merge_split(
+            scratch, elements, end - begin, &merge->comparison);
+}
+
+// How many of the first `position` merged elements come from `left`.
+static gen_size_t gen_sort_internal_merge_partition(
+        const gen_uint8_t* const restrict left, const gen_size_t left_count,
+        const gen_uint8_t* const restrict right, const gen_size_t right_count,
+        const gen_size_t position,
+        const gen_sort_internal_comparison_t* const restrict comparison) {
+
+    const gen_size_t size = comparison->size;
+
+    gen_size_t low = position > right_count ? position - right_count : 0;
+    gen_size_t high = GEN_MINIMUM(position, left_count);
+
+    while(low < high) {
+        const gen_size_t i = low + (high - low) / 2;
+        const gen_size_t j = position - i;
+
+        // Too few were taken from the left if its next element would be
+        // merged ahead of the last one taken from the right.
+        if(j && !comparison->less(
+                right + (j - 1) * size, left + i * size,
+                comparison->user_data)) {
+            low = i + 1;
+        }
+        else high = i;
+    }
+
+    return low;
+}
+
+static void gen_sort_internal_merge_task(
+        void* const restrict context, const gen_size_t index) {
+
+    gen_sort_internal_merge_t* const merge = context;
+    const gen_sort_internal_merge_task_t* const task = &merge->tasks[index];
+
+    const gen_size_t size = merge->comparison.size;
+    const gen_uint8_t* const left = merge->from + task->left * size;
+    const gen_uint8_t* const right = left + task->left_count * size;
+    gen_uint8_t* const to = merge->to + task->left * size;
+
+    const gen_size_t left_begin = gen_sort_internal_merge_partition(
+            left, task->left_count, right, task->right_count, task->begin,
+            &merge->comparison);
+    const gen_size_t left_end = gen_sort_internal_merge_partition(
+            left, task->left_count, right, task->right_count, task->end,
+            &merge->comparison);
+
+    const gen_size_t right_begin = task->begin - left_begin;
+    const gen_size_t right_end = task->end - left_end;
+
+    gen_sort_internal_merge_runs(
+            left + left_begin * size, left_end - left_begin,
+            right + right_begin * size, right_end - right_begin,
+            to + task->begin * size, &merge->comparison);
+}
+
+static gen_error_t* gen_sort_internal_merge_parallel(
+        gen_sort_internal_merge_t* const restrict merge,
+        gen_size_t* const restrict bounds,
+        gen_thread_t* const restrict threads, const gen_size_t thread_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_sort_internal_queue_t queue = {
+        gen_sort_internal_merge_chunk_task, merge, thread_count, 0
+    };
+    error = gen_sort_internal_run(&queue, threads, thread_count);
+    if(error) return error;
+
+    gen_size_t runs = thread_count;
+    for(gen_size_t r = 0; r < runs; ++r) bounds[r] = r * merge->chunk_length;
+    bounds[runs] = merge->count;
+
+    merge->from = merge->elements;
+    merge->to = merge->scratch;
+
+    while(runs > 1) {
+        gen_size_t tasks = 0;
+
+        // An odd run out is carried over as a merge with nothing.
+        for(gen_size_t r = 0; r < runs; r += 2) {
+            const gen_size_t middle = bounds[r + 1];
+            const gen_size_t end = r + 1 < runs ? bounds[r + 2] : middle;
+            const gen_size_t length = end - bounds[r];
+
+            const gen_size_t pieces = GEN_MAXIMUM(
+                    (length * thread_count) / merge->count, 1);
+
+            for(gen_size_t p = 0; p < pieces; ++p) {
+                merge->tasks[tasks++] = (gen_sort_internal_merge_task_t) {
+                    bounds[r], middle - bounds[r], end - middle,
+                    (length * p) / pieces, (length * (p + 1)) / pieces
+                };
+            }
+
+            bounds[r / 2] = bounds[r];
+        }
+
+        runs = (runs + 1) / 2;
+        bounds[runs] = merge->count;
+
+        queue = (gen_sort_internal_queue_t) {
+            gen_sort_internal_merge_task, merge, tasks, 0
+        };
+        error = gen_sort_internal_run(&queue, threads, thread_count);
+        if(error) return error;
+
+        gen_uint8_t* const swap = merge->from;
+        merge->from = merge->to;
+        merge->to = swap;
+    }
+
+    if(merge->from != merge->elements) {
+        __builtin_memcpy(
+                merge->elements, merge->from,
+                merge->count * merge->comparison.size);
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_sort_merge(
+        void* const restrict elements, const gen_size_t count,
+        const gen_size_t size, const gen_sort_less_t less,
+        void* const restrict user_data, const gen_size_t thread_count,
+        const gen_system_allocator_t* const restrict allocator) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!elements && count) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`elements` was `GEN_NULL`");
+    }
+
+    if(!size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`size` was 0");
+    }
+
+    if(!less) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`less` was `GEN_NULL`");
+    }
+
+    if(!allocator) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`allocator` was `GEN_NULL`");
+    }
+
+    if(count < 2) return GEN_NULL;
+
+    gen_size_t bytes = 0;
+    if(__builtin_mul_overflow(count, size, &bytes)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "%uz elements of %uz bytes exceeded the address space", count,
+                size);
+    }
+
+    gen_size_t threads = 1;
+    error = gen_sort_internal_thread_count(thread_count, count, &threads);
+    if(error) return error;
+
+    gen_sort_internal_merge_t merge = {0};
+    merge.elements = elements;
+    merge.count = count;
+    merge.comparison = (gen_sort_internal_comparison_t) {
+        size, less, user_data
+    };
+    merge.chunk_length = (count + threads - 1) / threads;
+
+    // A round of merging has a task per pair of runs plus one for each
+    // thread its pieces are spread over.
+    const gen_size_t bounds = threads > 1 ? threads + 1 : 0;
+    const gen_size_t tasks = threads > 1 ? 2 * threads : 0;
+    const gen_size_t bookkeeping =
+            bounds * sizeof(gen_size_t) +
+            tasks * sizeof(gen_sort_internal_merge_task_t) +
+            (threads - 1) * sizeof(gen_thread_t);
+
+    if(bytes > GEN_SIZE_MAX - bookkeeping) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "%uz elements of %uz bytes exceeded the address space", count,
+                size);
+    }
+
+    void* const allocation = allocator->malloc(bookkeeping + bytes);
+    if(!allocation) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate %uz bytes of scratch space",
+                bookkeeping + bytes);
+    }
+
+    gen_size_t* const bound_storage = allocation;
+    merge.tasks = (void*) (bound_storage + bounds);
+    gen_thread_t* const thread_storage = (void*) (merge.tasks + tasks);
+    merge.scratch = (void*) (thread_storage + threads - 1);
+
+    if(threads > 1) {
+        error = gen_sort_internal_merge_parallel(
+                &merge, bound_storage, thread_storage, threads);
+    }
+    else {
+        __builtin_memcpy(merge.scratch, merge.elements, bytes);
+        gen_sort_internal_merge_split(
+                merge.scratch, merge.elements, count, &merge.comparison);
+    }
+
+    allocator->free(allocation);
+
+    return error;
+}
@@ -0,0 +1,915 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genstream.h"
+
+#define GEN_STREAM_INTERNAL_ONES 0x0101010101010101ull
+#define GEN_STREAM_INTERNAL_HIGHS 0x8080808080808080ull
+
+#define GEN_STREAM_INTERNAL_FRAME_MAGIC 0x184D2204u
+#define GEN_STREAM_INTERNAL_SKIPPABLE_MAGIC 0x184D2A50u
+#define GEN_STREAM_INTERNAL_SKIPPABLE_MASK 0xFFFFFFF0u
+
+#define GEN_STREAM_INTERNAL_FLAG_VERSION_MASK 0xC0
+#define GEN_STREAM_INTERNAL_FLAG_VERSION 0x40
+#define GEN_STREAM_INTERNAL_FLAG_INDEPENDENT 0x20
+#define GEN_STREAM_INTERNAL_FLAG_BLOCK_CHECKSUM 0x10
+#define GEN_STREAM_INTERNAL_FLAG_CONTENT_SIZE 0x08
+#define GEN_STREAM_INTERNAL_FLAG_CONTENT_CHECKSUM 0x04
+#define GEN_STREAM_INTERNAL_FLAG_RESERVED 0x02
+#define GEN_STREAM_INTERNAL_FLAG_DICTIONARY 0x01
+#define GEN_STREAM_INTERNAL_BLOCK_SIZE_RESERVED 0x8F
+
+// Block sizes are coded as 4 to 7 for 64KiB to 4MiB.
+#define GEN_STREAM_INTERNAL_BLOCK_SIZE_MINIMUM 4
+#define GEN_STREAM_INTERNAL_BLOCK_SIZE_MAXIMUM 7
+
+// Blocks which would not shrink are stored as they are instead.
+#define GEN_STREAM_INTERNAL_STORED_BLOCK 0x80000000u
+
+#define GEN_STREAM_INTERNAL_PRIME32_1 0x9E3779B1u
+#define GEN_STREAM_INTERNAL_PRIME32_2 0x85EBCA77u
+#define GEN_STREAM_INTERNAL_PRIME32_3 0xC2B2AE3Du
+#define GEN_STREAM_INTERNAL_PRIME32_4 0x27D4EB2Fu
+#define GEN_STREAM_INTERNAL_PRIME32_5 0x165667B1u
+
+// Finds `delimiter` a word at a time, setting the high bit of each byte in a
+// word which matches.
+static gen_size_t gen_stream_internal_find(
+        const gen_uint8_t* const restrict data, const gen_size_t size,
+        const char delimiter) {
+
+    const gen_uint64_t pattern =
+            GEN_STREAM_INTERNAL_ONES * (gen_uint8_t) delimiter;
+
+    gen_size_t i = 0;
+    for(; i + sizeof(gen_uint64_t) <= size; i += sizeof(gen_uint64_t)) {
+        gen_uint64_t word;
+        __builtin_memcpy(&word, data + i, sizeof(word));
+
+        const gen_uint64_t difference = word ^ pattern;
+        const gen_uint64_t matches =
+                (difference - GEN_STREAM_INTERNAL_ONES) & ~difference &
+                GEN_STREAM_INTERNAL_HIGHS;
+
+        if(matches) {
+            const int position = __builtin_ctzll(matches);
+            return i + (gen_size_t) position / 8;
+        }
+    }
+
+    for(; i < size; ++i) {
+        if(data[i] == (gen_uint8_t) delimiter) return i;
+    }
+
+    return size;
+}
+
+static gen_uint32_t gen_stream_internal_read32(
+        const gen_uint8_t* const restrict p) {
+
+    return (gen_uint32_t) p[0] | (gen_uint32_t) p[1] << 8 |
+            (gen_uint32_t) p[2] << 16 | (gen_uint32_t) p[3] << 24;
+}
+
+static void gen_stream_internal_write32(
+        gen_uint8_t* const restrict p, const gen_uint32_t x) {
+
+    p[0] = (gen_uint8_t) x;
+    p[1] = (gen_uint8_t) (x >> 8);
+    p[2] = (gen_uint8_t) (x >> 16);
+    p[3] = (gen_uint8_t) (x >> 24);
+}
+
+static gen_uint32_t gen_stream_internal_rotate(
+        const gen_uint32_t x, const gen_uint32_t amount) {
+
+    return (x << amount) | (x >> (32 - amount));
+}
+
+// The frame descriptor is checked with the second byte of its XXH32. No
+// descriptor reaches XXH32's 16 byte stripes, so only its tail is needed.
+static gen_uint8_t gen_stream_internal_descriptor_checksum(
+        const gen_uint8_t* const restrict descriptor, const gen_size_t size) {
+
+    gen_uint32_t hash = GEN_STREAM_INTERNAL_PRIME32_5 + (gen_uint32_t) size;
+
+    gen_size_t i = 0;
+    for(; i + sizeof(gen_uint32_t) <= size; i += sizeof(gen_uint32_t)) {
+        hash += gen_stream_internal_read32(descriptor + i) *
+                GEN_STREAM_INTERNAL_PRIME32_3;
+        hash = gen_stream_internal_rotate(hash, 17) *
+                GEN_STREAM_INTERNAL_PRIME32_4;
+    }
+
+    for(; i < size; ++i) {
+        hash += descriptor[i] * GEN_STREAM_INTERNAL_PRIME32_5;
+        hash = gen_stream_internal_rotate(hash, 11) *
+                GEN_STREAM_INTERNAL_PRIME32_1;
+    }
+
+    hash ^= hash >> 15;
+    hash *= GEN_STREAM_INTERNAL_PRIME32_2;
+    hash ^= hash >> 13;
+    hash *= GEN_STREAM_INTERNAL_PRIME32_3;
+    hash ^= hash >> 16;
+
+    return (gen_uint8_t) (hash >> 8);
+}
+
+static gen_error_t* gen_stream_internal_allocate(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, gen_size_t* const capacity,
+        gen_uint8_t** const restrict out_buffer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!allocator) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`allocator` was `GEN_NULL`");
+    }
+
+    if(!file) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`file` was `GEN_NULL`");
+    }
+
+    if(!*capacity) *capacity = GEN_STREAM_DEFAULT_CAPACITY;
+
+    *out_buffer = allocator->malloc(*capacity);
+    if(!*out_buffer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate %uz byte stream buffer", *capacity);
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_reader_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_reader_t* const restrict out_reader) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_reader) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_reader` was `GEN_NULL`");
+    }
+
+    if(file && !(file->access & GEN_FILE_ACCESS_READ)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                "`file` was not opened for reading");
+    }
+
+    *out_reader = (gen_stream_reader_t) {0};
+    out_reader->capacity = capacity;
+
+    error = gen_stream_internal_allocate(
+            allocator, file, &out_reader->capacity, &out_reader->buffer);
+    if(error) return error;
+
+    // Streams only ever read forwards, which lets the platform read ahead
+    // more aggressively.
+    error = gen_file_advise(file, GEN_FILE_ADVICE_SEQUENTIAL);
+    if(error) {
+        allocator->free(out_reader->buffer);
+        *out_reader = (gen_stream_reader_t) {0};
+        return error;
+    }
+
+    out_reader->allocator = *allocator;
+    out_reader->file = file;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_reader_create_decompressed(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_reader_t* const restrict out_reader) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_stream_reader_create(allocator, file, capacity, out_reader);
+    if(error) return error;
+
+    // Nothing is read until the first fill, so that opening a stream never
+    // blocks.
+    out_reader->decompressing = gen_true;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_reader_destroy(
+        gen_stream_reader_t* const restrict reader) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!reader) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`reader` was `GEN_NULL`");
+    }
+
+    reader->allocator.free(reader->buffer);
+    reader->allocator.free(reader->compressed);
+    reader->allocator.free(reader->block);
+
+    *reader = (gen_stream_reader_t) {0};
+
+    return GEN_NULL;
+}
+
+// Reads until `size` bytes have arrived or the file ends.
+static gen_error_t* gen_stream_reader_internal_read_fully(
+        gen_stream_reader_t* const restrict reader,
+        void* const restrict buffer, const gen_size_t size,
+        gen_size_t* const restrict out_read) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint8_t* const bytes = buffer;
+    gen_size_t total = 0;
+
+    while(total < size) {
+        gen_size_t read = 0;
+        error = gen_file_read(
+                reader->file, bytes + total, size - total, &read);
+        if(error) return error;
+
+        if(!read) break;
+        total += read;
+    }
+
+    *out_read = total;
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_stream_reader_internal_read_exact(
+        gen_stream_reader_t* const restrict reader,
+        void* const restrict buffer, const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_size_t read = 0;
+    error = gen_stream_reader_internal_read_fully(reader, buffer, size, &read);
+    if(error) return error;
+
+    if(read < size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                "Compressed stream ended part way through a frame");
+    }
+
+    return GEN_NULL;
+}
+
+// Checksums and skippable frames are read past rather than seeked over, as
+// the file may be a pipe.
+static gen_error_t* gen_stream_reader_internal_skip(
+        gen_stream_reader_t* const restrict reader, gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint8_t discard[256];
+
+    while(size) {
+        const gen_size_t amount = GEN_MINIMUM(size, sizeof(discard));
+        error = gen_stream_reader_internal_read_exact(reader, discard, amount);
+        if(error) return error;
+
+        size -= amount;
+    }
+
+    return GEN_NULL;
+}
+
+// Reads a frame header, checking that it describes a frame we can decode and
+// sizing the block buffers to match.
+static gen_error_t* gen_stream_reader_internal_frame(
+        gen_stream_reader_t* const restrict reader) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // FLG and BD, an optional content size and the header checksum.
+    gen_uint8_t descriptor[2 + sizeof(gen_uint64_t) + 1];
+
+    error = gen_stream_reader_internal_read_exact(reader, descriptor, 2);
+    if(error) return error;
+
+    const gen_uint8_t flags = descriptor[0];
+    const gen_uint8_t sizing = descriptor[1];
+
+    if((flags & GEN_STREAM_INTERNAL_FLAG_VERSION_MASK) !=
+            GEN_STREAM_INTERNAL_FLAG_VERSION ||
+            (flags & GEN_STREAM_INTERNAL_FLAG_RESERVED) ||
+            (sizing & GEN_STREAM_INTERNAL_BLOCK_SIZE_RESERVED)) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                "Compressed stream had an unrecognized frame descriptor");
+    }
+
+    if(flags & GEN_STREAM_INTERNAL_FLAG_DICTIONARY) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_NOT_IMPLEMENTED, GEN_LINE_STRING,
+                "Frames compressed with a dictionary are not supported");
+    }
+
+    if(!(flags & GEN_STREAM_INTERNAL_FLAG_INDEPENDENT)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_NOT_IMPLEMENTED, GEN_LINE_STRING,
+                "Frames with linked blocks are not supported");
+    }
+
+    const gen_size_t size =
+            2 + (flags & GEN_STREAM_INTERNAL_FLAG_CONTENT_SIZE ?
+                    sizeof(gen_uint64_t) : 0);
+
+    error = gen_stream_reader_internal_read_exact(
+            reader, descriptor + 2, size - 2 + 1);
+    if(error) return error;
+
+    if(gen_stream_internal_descriptor_checksum(descriptor, size) !=
+            descriptor[size]) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                "Compressed stream had a corrupt frame descriptor");
+    }
+
+    const gen_size_t block_size = sizing >> 4;
+    if(block_size < GEN_STREAM_INTERNAL_BLOCK_SIZE_MINIMUM) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                "Compressed stream had an invalid block size %uz",
+                block_size);
+    }
+
+    const gen_size_t maximum = (gen_size_t) 1 << (2 * block_size + 8);
+
+    if(maximum > reader->block_capacity) {
+        reader->allocator.free(reader->compressed);
+        reader->allocator.free(reader->block);
+        reader->block_capacity = 0;
+
+        reader->compressed = reader->allocator.malloc(maximum);
+        reader->block = reader->allocator.malloc(maximum);
+        if(!reader->compressed || !reader->block) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to allocate %uz byte block buffers", maximum);
+        }
+
+        reader->block_capacity = maximum;
+    }
+
+    reader->frame_flags = flags;
+    reader->in_frame = gen_true;
+
+    return GEN_NULL;
+}
+
+// Decompresses the next non-empty block, moving on through frames as they
+// end. Running out of file between frames exhausts the reader.
+static gen_error_t* gen_stream_reader_internal_next_block(
+        gen_stream_reader_t* const restrict reader) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    reader->block_start = 0;
+    reader->block_end = 0;
+
+    while(gen_true) {
+        gen_uint8_t word[sizeof(gen_uint32_t)];
+
+        if(!reader->in_frame) {
+            gen_size_t read = 0;
+            error = gen_stream_reader_internal_read_fully(
+                    reader, word, sizeof(word), &read);
+            if(error) return error;
+
+            if(!read) {
+                reader->exhausted = gen_true;
+                return GEN_NULL;
+            }
+
+            if(read < sizeof(word)) {
+                return gen_error_attach_backtrace(
+                        GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                        "Compressed stream ended part way through a frame");
+            }
+
+            const gen_uint32_t magic = gen_stream_internal_read32(word);
+
+            if((magic & GEN_STREAM_INTERNAL_SKIPPABLE_MASK) ==
+                    GEN_STREAM_INTERNAL_SKIPPABLE_MAGIC) {
+
+                error = gen_stream_reader_internal_read_exact(
+                        reader, word, sizeof(word));
+                if(error) return error;
+
+                error = gen_stream_reader_internal_skip(
+                        reader, gen_stream_internal_read32(word));
+                if(error) return error;
+
+                continue;
+            }
+
+            if(magic != GEN_STREAM_INTERNAL_FRAME_MAGIC) {
+                return gen_error_attach_backtrace(
+                        GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                        "Compressed stream did not hold an LZ4 frame");
+            }
+
+            error = gen_stream_reader_internal_frame(reader);
+            if(error) return error;
+        }
+
+        error = gen_stream_reader_internal_read_exact(
+                reader, word, sizeof(word));
+        if(error) return error;
+
+        gen_uint32_t size = gen_stream_internal_read32(word);
+
+        // Content checksums are skipped rather than verified, as the block
+        // decoder already refuses anything which would overrun.
+        if(!size) {
+            if(reader->frame_flags &
+                    GEN_STREAM_INTERNAL_FLAG_CONTENT_CHECKSUM) {
+
+                error = gen_stream_reader_internal_skip(
+                        reader, sizeof(gen_uint32_t));
+                if(error) return error;
+            }
+
+            reader->in_frame = gen_false;
+            continue;
+        }
+
+        const gen_bool_t stored = size & GEN_STREAM_INTERNAL_STORED_BLOCK;
+        size &= ~GEN_STREAM_INTERNAL_STORED_BLOCK;
+
+        if(size > reader->block_capacity) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "Compressed block of %uz bytes exceeded the frame's block "
+                    "size of %uz",
+                    (gen_size_t) size, reader->block_capacity);
+        }
+
+        if(stored) {
+            error = gen_stream_reader_internal_read_exact(
+                    reader, reader->block, size);
+            if(error) return error;
+
+            reader->block_end = size;
+        }
+        else {
+            error = gen_stream_reader_internal_read_exact(
+                    reader, reader->compressed, size);
+            if(error) return error;
+
+            error = gen_decompress(
+                    reader->compressed, size, reader->block,
+                    reader->block_capacity, &reader->block_end);
+            if(error) return error;
+        }
+
+        if(reader->frame_flags & GEN_STREAM_INTERNAL_FLAG_BLOCK_CHECKSUM) {
+            error = gen_stream_reader_internal_skip(
+                    reader, sizeof(gen_uint32_t));
+            if(error) return error;
+        }
+
+        if(reader->block_end) return GEN_NULL;
+    }
+}
+
+// Moves unconsumed data to the front of the buffer and reads more after it.
+static gen_error_t* gen_stream_reader_internal_fill(
+        gen_stream_reader_t* const restrict reader) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(reader->start) {
+        __builtin_memmove(
+                reader->buffer, reader->buffer + reader->start,
+                reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+
+    if(reader->decompressing) {
+        if(reader->block_start == reader->block_end) {
+            error = gen_stream_reader_internal_next_block(reader);
+            if(error) return error;
+
+            if(reader->exhausted) return GEN_NULL;
+        }
+
+        const gen_size_t amount = GEN_MINIMUM(
+                reader->block_end - reader->block_start,
+                reader->capacity - reader->end);
+        __builtin_memcpy(
+                reader->buffer + reader->end,
+                reader->block + reader->block_start, amount);
+        reader->block_start += amount;
+        reader->end += amount;
+
+        return GEN_NULL;
+    }
+
+    gen_size_t read = 0;
+    error = gen_file_read(
+            reader->file, reader->buffer + reader->end,
+            reader->capacity - reader->end, &read);
+    if(error) return error;
+
+    if(!read) reader->exhausted = gen_true;
+    reader->end += read;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_reader_read(
+        gen_stream_reader_t* const restrict reader,
+        void* const restrict buffer, const gen_size_t size,
+        gen_size_t* const restrict out_read) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!reader) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`reader` was `GEN_NULL`");
+    }
+
+    if(!buffer && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`buffer` was `GEN_NULL`");
+    }
+
+    if(!out_read) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_read` was `GEN_NULL`");
+    }
+
+    gen_uint8_t* const bytes = buffer;
+    gen_size_t copied = 0;
+
+    while(copied < size) {
+        const gen_size_t buffered = reader->end - reader->start;
+        if(buffered) {
+            const gen_size_t amount = GEN_MINIMUM(buffered, size - copied);
+            __builtin_memcpy(
+                    bytes + copied, reader->buffer + reader->start, amount);
+            reader->start += amount;
+            copied += amount;
+            continue;
+        }
+
+        if(reader->exhausted) break;
+
+        if(!reader->decompressing && size - copied >= reader->capacity) {
+            gen_size_t read = 0;
+            error = gen_file_read(
+                    reader->file, bytes + copied, size - copied, &read);
+            if(error) return error;
+
+            if(!read) reader->exhausted = gen_true;
+            copied += read;
+            continue;
+        }
+
+        error = gen_stream_reader_internal_fill(reader);
+        if(error) return error;
+    }
+
+    *out_read = copied;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_reader_next_record(
+        gen_stream_reader_t* const restrict reader, const char delimiter,
+        const char** const restrict out_record,
+        gen_size_t* const restrict out_size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!reader) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`reader` was `GEN_NULL`");
+    }
+
+    if(!out_record) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_record` was `GEN_NULL`");
+    }
+
+    if(!out_size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_size` was `GEN_NULL`");
+    }
+
+    // Bytes already searched are skipped when more data is read in.
+    gen_size_t searched = 0;
+
+    while(gen_true) {
+        const gen_uint8_t* const record = reader->buffer + reader->start;
+        const gen_size_t buffered = reader->end - reader->start;
+
+        const gen_size_t found =
+                searched + gen_stream_internal_find(
+                        record + searched, buffered - searched, delimiter);
+
+        if(found < buffered) {
+            *out_record = (const char*) record;
+            *out_size = found;
+            reader->start += found + 1;
+
+            return GEN_NULL;
+        }
+
+        if(reader->exhausted) {
+            *out_record = buffered ? (const char*) record : GEN_NULL;
+            *out_size = buffered;
+            reader->start = reader->end;
+
+            return GEN_NULL;
+        }
+
+        if(buffered == reader->capacity) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                    "Record exceeded the stream buffer size of %uz",
+                    reader->capacity);
+        }
+
+        searched = buffered;
+
+        error = gen_stream_reader_internal_fill(reader);
+        if(error) return error;
+    }
+}
+
+gen_error_t* gen_stream_writer_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_writer_t* const restrict out_writer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_writer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_writer` was `GEN_NULL`");
+    }
+
+    if(file && !(file->access & GEN_FILE_ACCESS_WRITE)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_PERMISSION, GEN_LINE_STRING,
+                "`file` was not opened for writing");
+    }
+
+    *out_writer = (gen_stream_writer_t) {0};
+    out_writer->capacity = capacity;
+
+    error = gen_stream_internal_allocate(
+            allocator, file, &out_writer->capacity, &out_writer->buffer);
+    if(error) return error;
+
+    out_writer->allocator = *allocator;
+    out_writer->file = file;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_writer_create_compressed(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_writer_t* const restrict out_writer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(capacity > GEN_STREAM_MAXIMUM_COMPRESSED_CAPACITY) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`capacity` exceeded the largest block size of %uz",
+                (gen_size_t) GEN_STREAM_MAXIMUM_COMPRESSED_CAPACITY);
+    }
+
+    error = gen_stream_writer_create(allocator, file, capacity, out_writer);
+    if(error) return error;
+
+    error = gen_compressor_create(allocator, 0, &out_writer->compressor);
+    if(error) {
+        allocator->free(out_writer->buffer);
+        *out_writer = (gen_stream_writer_t) {0};
+
+        return error;
+    }
+
+    // Room for each block's size ahead of it.
+    const gen_size_t compressed_capacity =
+            sizeof(gen_uint32_t) + GEN_COMPRESS_BOUND(out_writer->capacity);
+
+    out_writer->compressed = allocator->malloc(compressed_capacity);
+    if(!out_writer->compressed) {
+        gen_compressor_destroy(&out_writer->compressor);
+        allocator->free(out_writer->buffer);
+        *out_writer = (gen_stream_writer_t) {0};
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate %uz byte compression buffer",
+                compressed_capacity);
+    }
+
+    // The smallest block size which fits a whole buffer.
+    gen_size_t block_size = GEN_STREAM_INTERNAL_BLOCK_SIZE_MINIMUM;
+    while(((gen_size_t) 1 << (2 * block_size + 8)) < out_writer->capacity) {
+        ++block_size;
+    }
+
+    gen_uint8_t header[sizeof(gen_uint32_t) + 3];
+    gen_stream_internal_write32(header, GEN_STREAM_INTERNAL_FRAME_MAGIC);
+    header[4] = GEN_STREAM_INTERNAL_FLAG_VERSION |
+            GEN_STREAM_INTERNAL_FLAG_INDEPENDENT;
+    header[5] = (gen_uint8_t) (block_size << 4);
+    header[6] = gen_stream_internal_descriptor_checksum(header + 4, 2);
+
+    error = gen_file_write(file, header, sizeof(header));
+    if(error) {
+        allocator->free(out_writer->compressed);
+        gen_compressor_destroy(&out_writer->compressor);
+        allocator->free(out_writer->buffer);
+        *out_writer = (gen_stream_writer_t) {0};
+
+        return error;
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_writer_destroy(
+        gen_stream_writer_t* const restrict writer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!writer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`writer` was `GEN_NULL`");
+    }
+
+    // The buffer is released even if the final flush fails.
+    error = gen_stream_writer_flush(writer);
+
+    if(writer->compressed) {
+        if(!error) {
+            const gen_uint8_t end_mark[sizeof(gen_uint32_t)] = {0};
+            error = gen_file_write(writer->file, end_mark, sizeof(end_mark));
+        }
+
+        writer->allocator.free(writer->compressed);
+        gen_compressor_destroy(&writer->compressor);
+    }
+
+    writer->allocator.free(writer->buffer);
+
+    *writer = (gen_stream_writer_t) {0};
+
+    return error;
+}
+
+// Writes out `size` bytes, which must be no more than the capacity when
+// compressing, as a block of the frame.
+static gen_error_t* gen_stream_writer_internal_write_block(
+        gen_stream_writer_t* const restrict writer,
+        const gen_uint8_t* const restrict data, const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!writer->compressed) return gen_file_write(writer->file, data, size);
+
+    gen_uint8_t* const block = writer->compressed + sizeof(gen_uint32_t);
+
+    gen_size_t compressed_size = 0;
+    error = gen_compressor_compress(
+            &writer->compressor, data, size, block,
+            GEN_COMPRESS_BOUND(writer->capacity), &compressed_size);
+    if(error) return error;
+
+    gen_uint32_t header = (gen_uint32_t) compressed_size;
+
+    if(compressed_size >= size) {
+        __builtin_memcpy(block, data, size);
+        compressed_size = size;
+        header = (gen_uint32_t) size | GEN_STREAM_INTERNAL_STORED_BLOCK;
+    }
+
+    gen_stream_internal_write32(writer->compressed, header);
+
+    return gen_file_write(
+            writer->file, writer->compressed,
+            sizeof(gen_uint32_t) + compressed_size);
+}
+
+gen_error_t* gen_stream_writer_write(
+        gen_stream_writer_t* const restrict writer,
+        const void* const restrict buffer, const gen_size_t size) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!writer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`writer` was `GEN_NULL`");
+    }
+
+    if(!buffer && size) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`buffer` was `GEN_NULL`");
+    }
+
+    if(size > writer->capacity - writer->length) {
+        error = gen_stream_writer_flush(writer);
+        if(error) return error;
+    }
+
+    if(size >= writer->capacity) {
+        if(!writer->compressed) {
+            return gen_file_write(writer->file, buffer, size);
+        }
+
+        // Blocks may not grow past the size given in the frame header.
+        const gen_uint8_t* const bytes = buffer;
+        for(gen_size_t i = 0; i < size; i += writer->capacity) {
+            error = gen_stream_writer_internal_write_block(
+                    writer, bytes + i, GEN_MINIMUM(writer->capacity, size - i));
+            if(error) return error;
+        }
+
+        return GEN_NULL;
+    }
+
+    __builtin_memcpy(writer->buffer + writer->length, buffer, size);
+    writer->length += size;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_stream_writer_flush(
+        gen_stream_writer_t* const restrict writer) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!writer) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`writer` was `GEN_NULL`");
+    }
+
+    if(!writer->length) return GEN_NULL;
+
+    error = gen_stream_writer_internal_write_block(
+            writer, writer->buffer, writer->length);
+    if(error) return error;
+
+    writer->length = 0;
+
+    return GEN_NULL;
+}
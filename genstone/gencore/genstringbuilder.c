@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genstringbuilder.h"
+#include "include/genformat.h"
+
+gen_error_t* gen_string_builder_create(
+        const gen_system_allocator_t* const restrict allocator,
+        gen_string_builder_t* const restrict out_builder) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!allocator) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`allocator` was `GEN_NULL`");
+    }
+
+    if(!out_builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_builder` was `GEN_NULL`");
+    }
+
+    out_builder->allocator = *allocator;
+    out_builder->heap = GEN_NULL;
+    out_builder->length = 0;
+    out_builder->capacity = GEN_STRING_BUILDER_INLINE_CAPACITY;
+    out_builder->storage[0] = '\0';
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_string_builder_destroy(
+        gen_string_builder_t* const restrict builder) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`builder` was `GEN_NULL`");
+    }
+
+    if(builder->heap) builder->allocator.free(builder->heap);
+
+    builder->heap = GEN_NULL;
+    builder->length = 0;
+    builder->capacity = GEN_STRING_BUILDER_INLINE_CAPACITY;
+    builder->storage[0] = '\0';
+
+    return GEN_NULL;
+}
+
+void gen_string_builder_internal_auto_destroy(
+        gen_string_builder_t* const restrict builder) {
+
+    if(builder->heap) builder->allocator.free(builder->heap);
+}
+
+char* gen_string_builder_internal_data(
+        gen_string_builder_t* const restrict builder) {
+
+    return builder->heap ? builder->heap : builder->storage;
+}
+
+gen_bool_t gen_string_builder_internal_grow(
+        gen_string_builder_t* const restrict builder,
+        const gen_size_t capacity) {
+
+    if(capacity <= builder->capacity) return gen_true;
+
+    // The null terminator needs one more byte on top.
+    if(capacity == GEN_SIZE_MAX) return gen_false;
+
+    // Builders set up statically without an allocator stay inline.
+    if(!builder->allocator.malloc) return gen_false;
+
+    // Doubling keeps the cost of appending a byte at a time amortized O(1).
+    const gen_size_t grown = builder->capacity > GEN_SIZE_MAX / 4 ?
+            capacity : GEN_MAXIMUM(builder->capacity * 2, capacity);
+
+    char* const heap = builder->heap ?
+            builder->allocator.realloc(builder->heap, grown + 1) :
+            builder->allocator.malloc(grown + 1);
+    if(!heap) return gen_false;
+
+    // All of the inline storage is moved since formatting writes past the
+    // length before committing to it.
+    if(!builder->heap) {
+        for(gen_size_t i = 0; i < builder->capacity; ++i) {
+            heap[i] = builder->storage[i];
+        }
+    }
+
+    builder->heap = heap;
+    builder->capacity = grown;
+
+    return gen_true;
+}
+
+gen_error_t* gen_string_builder_reserve(
+        gen_string_builder_t* const restrict builder,
+        const gen_size_t additional) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`builder` was `GEN_NULL`");
+    }
+
+    if(additional > GEN_SIZE_MAX - builder->length) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_TOO_LONG, GEN_LINE_STRING,
+                "Reserving %uz bytes would overflow the builder", additional);
+    }
+
+    const gen_size_t capacity = builder->length + additional;
+    if(!gen_string_builder_internal_grow(builder, capacity)) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to grow string builder to %uz bytes", capacity);
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_string_builder_append(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict string, const gen_size_t length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!string) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`string` was `GEN_NULL`");
+    }
+
+    error = gen_string_builder_reserve(builder, length);
+    if(error) return error;
+
+    char* const data = gen_string_builder_internal_data(builder);
+    for(gen_size_t i = 0; i < length; ++i) {
+        data[builder->length + i] = string[i];
+    }
+
+    builder->length += length;
+    data[builder->length] = '\0';
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_string_builder_format(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict format, ...) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    GEN_VARIADIC_LIST_AUTO gen_variadic_list_t list;
+    gen_variadic_list_start(list, format);
+
+    return gen_string_builder_format_variadic_list(builder, format, list);
+}
+
+gen_error_t* gen_string_builder_format_variadic_list(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict format, gen_variadic_list_t list) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`builder` was `GEN_NULL`");
+    }
+
+    gen_bool_t exhausted = gen_false;
+    error = gen_format_internal_builder_variadic_list(
+            builder, format, list, &exhausted);
+    if(error) return error;
+
+    if(exhausted) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to grow string builder past %uz bytes",
+                builder->capacity);
+    }
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_string_builder_truncate(
+        gen_string_builder_t* const restrict builder, const gen_size_t length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`builder` was `GEN_NULL`");
+    }
+
+    if(length > builder->length) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_BOUNDS, GEN_LINE_STRING,
+                "`length` %uz exceeded the string's length %uz", length,
+                builder->length);
+    }
+
+    builder->length = length;
+    gen_string_builder_internal_data(builder)[length] = '\0';
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_string_builder_get(
+        const gen_string_builder_t* const restrict builder,
+        const char** const restrict out_string,
+        gen_size_t* const restrict out_length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`builder` was `GEN_NULL`");
+    }
+
+    if(!out_string) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_string` was `GEN_NULL`");
+    }
+
+    *out_string = builder->heap ? builder->heap : builder->storage;
+    if(out_length) *out_length = builder->length;
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_string_builder_take(
+        gen_string_builder_t* const restrict builder,
+        char** const restrict out_string,
+        gen_size_t* const restrict out_length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!builder) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`builder` was `GEN_NULL`");
+    }
+
+    if(!out_string) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_string` was `GEN_NULL`");
+    }
+
+    char* string = builder->heap;
+    if(!string) {
+        string = builder->allocator.malloc(builder->length + 1);
+        if(!string) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to allocate %uz bytes", builder->length + 1);
+        }
+
+        for(gen_size_t i = 0; i <= builder->length; ++i) {
+            string[i] = builder->storage[i];
+        }
+    }
+
+    *out_string = string;
+    if(out_length) *out_length = builder->length;
+
+    builder->heap = GEN_NULL;
+    builder->length = 0;
+    builder->capacity = GEN_STRING_BUILDER_INLINE_CAPACITY;
+    builder->storage[0] = '\0';
+
+    return GEN_NULL;
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/genthread.h"
+
+#include <genbackends.h>
+
+GEN_BACKENDS_PROC(thread_create, gen_error_t*)
+gen_error_t* gen_thread_create(
+        const gen_thread_proc_t proc, void* const restrict user_data,
+        gen_thread_t* const restrict out_thread) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!proc) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`proc` was `GEN_NULL`");
+    }
+
+    if(!out_thread) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_thread` was `GEN_NULL`");
+    }
+
+    *out_thread = (gen_thread_t) {0};
+
+    return gen_backends_thread_create(proc, user_data, out_thread);
+}
+
+GEN_BACKENDS_PROC(thread_join, gen_error_t*)
+gen_error_t* gen_thread_join(
+        gen_thread_t* const restrict thread,
+        gen_bool_t* const restrict out_failed) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!thread) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`thread` was `GEN_NULL`");
+    }
+
+    if(!out_failed) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_failed` was `GEN_NULL`");
+    }
+
+    *out_failed = gen_false;
+
+    error = gen_backends_thread_join(thread, out_failed);
+    if(error) return error;
+
+    *thread = (gen_thread_t) {0};
+
+    return GEN_NULL;
+}
+
+GEN_BACKENDS_PROC(thread_get_processor_count, gen_error_t*)
+gen_error_t* gen_thread_get_processor_count(
+        gen_size_t* const restrict out_count) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_count) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_count` was `GEN_NULL`");
+    }
+
+    *out_count = 1;
+
+    return gen_backends_thread_get_processor_count(out_count);
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include "include/gentime.h"
+
+#include <genbackends.h>
+
+#ifndef GEN_TIME_CALIBRATION_PERIOD
+#define GEN_TIME_CALIBRATION_PERIOD 5000000ull
+#endif
+
+static gen_uint64_t gen_time_internal_cycle_frequency = 0;
+
+GEN_BACKENDS_PROC(time_get_monotonic, gen_error_t*)
+gen_error_t* gen_time_get_monotonic(gen_uint64_t* const restrict out_time) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_time) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_time` was `GEN_NULL`");
+    }
+
+    return gen_backends_time_get_monotonic(out_time);
+}
+
+GEN_BACKENDS_PROC(time_get_cycles, gen_error_t*)
+gen_error_t* gen_time_get_cycles(gen_uint64_t* const restrict out_cycles) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_cycles) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_cycles` was `GEN_NULL`");
+    }
+
+    return gen_backends_time_get_cycles(out_cycles);
+}
+
+gen_error_t* gen_time_get_cycle_frequency(
+        gen_uint64_t* const restrict out_frequency) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_frequency) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_frequency` was `GEN_NULL`");
+    }
+
+    // Racing calibrations are harmless - they just land on similar values.
+    *out_frequency = __atomic_load_n(
+            &gen_time_internal_cycle_frequency, __ATOMIC_RELAXED);
+    if(*out_frequency) return GEN_NULL;
+
+    gen_uint64_t start_time = 0;
+    gen_uint64_t start_cycles = 0;
+    gen_uint64_t time = 0;
+    gen_uint64_t cycles = 0;
+
+    error = gen_backends_time_get_monotonic(&start_time);
+    if(error) return error;
+
+    error = gen_backends_time_get_cycles(&start_cycles);
+    if(error) return error;
+
+    do {
+        error = gen_backends_time_get_monotonic(&time);
+        if(error) return error;
+    } while(time - start_time < GEN_TIME_CALIBRATION_PERIOD);
+
+    error = gen_backends_time_get_cycles(&cycles);
+    if(error) return error;
+
+    *out_frequency =
+            (cycles - start_cycles) * GEN_TIME_NANOSECONDS_PER_SECOND /
+            (time - start_time);
+    if(!*out_frequency) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                "The cycle counter did not advance during calibration");
+    }
+
+    __atomic_store_n(
+            &gen_time_internal_cycle_frequency, *out_frequency,
+            __ATOMIC_RELAXED);
+
+    return GEN_NULL;
+}
+
+gen_error_t* gen_time_cycles_to_nanoseconds(
+        const gen_uint64_t cycles, gen_uint64_t* const restrict out_time) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(!out_time) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`out_time` was `GEN_NULL`");
+    }
+
+    gen_uint64_t frequency = 0;
+    error = gen_time_get_cycle_frequency(&frequency);
+    if(error) return error;
+
+    // Split to avoid overflowing on long intervals.
+    const gen_uint64_t seconds = cycles / frequency;
+    const gen_uint64_t remainder = cycles % frequency;
+
+    *out_time =
+            seconds * GEN_TIME_NANOSECONDS_PER_SECOND +
+            remainder * GEN_TIME_NANOSECONDS_PER_SECOND / frequency;
+
+    return GEN_NULL;
+}
@@ -20,9 +20,27 @@ typedef struct {
     gen_free_t free;
 } gen_system_allocator_t;
 
+// Allocations made through the system allocator are counted process-wide so
+// that their usage can be inspected with `gen_allocator_get_statistics`.
 gen_error_t* gen_get_system_allocator(
                 gen_system_allocator_t* const restrict out_allocator);
 
+typedef struct {
+    // The number of allocations made, including reallocations.
+    gen_size_t allocations;
+    // The number of bytes currently allocated.
+    gen_size_t bytes;
+    // The highest value `bytes` has reached.
+    gen_size_t peak_bytes;
+} gen_allocator_statistics_t;
+
+gen_error_t* gen_allocator_get_statistics(
+        gen_allocator_statistics_t* const restrict out_statistics);
+
+// Zeroes the allocation count and lowers the peak to the bytes currently
+// allocated, so that usage can be measured from this point onward.
+gen_error_t* gen_allocator_reset_statistics(void);
+
 typedef struct {
     gen_size_t block_size;
 
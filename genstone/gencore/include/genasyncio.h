@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_ASYNC_IO_H
+#define GEN_ASYNC_IO_H
+
+#include "gencommon.h"
+#include "genio.h"
+
+typedef enum {
+    GEN_ASYNC_IO_OPERATION_READ,
+    GEN_ASYNC_IO_OPERATION_WRITE,
+    GEN_ASYNC_IO_OPERATION_SYNC
+} gen_async_io_operation_t;
+
+typedef struct {
+    gen_async_io_operation_t operation;
+    const gen_file_t* file;
+
+    void* buffer;
+    gen_size_t size;
+    gen_size_t offset;
+
+    void* user_data;
+} gen_async_io_request_t;
+
+typedef struct {
+    void* user_data;
+
+    gen_size_t transferred;
+    gen_bool_t failed;
+    gen_error_type_t error;
+} gen_async_io_completion_t;
+
+typedef struct {
+    void* data;
+    gen_size_t size;
+} gen_async_io_buffer_t;
+
+// At most `depth` requests may be in flight at once - completions must be
+// reaped to make room for further submissions.
+typedef struct {
+    gen_size_t depth;
+    gen_size_t in_flight;
+
+    void* native;
+} gen_async_io_queue_t;
+
+gen_error_t* gen_async_io_queue_create(
+        const gen_size_t depth,
+        gen_async_io_queue_t* const restrict out_queue);
+
+gen_error_t* gen_async_io_queue_destroy(
+        gen_async_io_queue_t* const restrict queue);
+
+// Requests whose buffers lie within a registered buffer can skip per-request
+// page pinning on backends which support it. Registering replaces any
+// previously registered buffers.
+gen_error_t* gen_async_io_register_buffers(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_buffer_t* const restrict buffers,
+        const gen_size_t count);
+
+// Requests may transfer at most `GEN_UINT32_MAX` bytes each - larger transfers
+// must be split across several requests.
+// If an error is returned, some leading part of the batch may still have been
+// submitted - these requests are counted in `in_flight` and must be reaped.
+gen_error_t* gen_async_io_submit(
+        gen_async_io_queue_t* const restrict queue,
+        const gen_async_io_request_t* const restrict requests,
+        const gen_size_t count);
+
+// Waits for at least `minimum` completions (capped to the number in flight)
+// and then collects up to `limit` completions. If an error is returned while
+// waiting, `out_count` still holds the completions collected before it.
+gen_error_t* gen_async_io_reap(
+        gen_async_io_queue_t* const restrict queue,
+        gen_async_io_completion_t* const restrict out_completions,
+        const gen_size_t limit, const gen_size_t minimum,
+        gen_size_t* const restrict out_count);
+
+#endif
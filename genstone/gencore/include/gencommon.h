@@ -31,11 +31,14 @@
 #define GEN_USED __attribute__((used))
 #define GEN_PACKED __attribute__((packed))
 #define GEN_INITIALIZER __attribute__((constructor))
+#define GEN_FINALIZER __attribute__((destructor))
 #define GEN_FALLTHROUGH __attribute__((fallthrough))
 #define GEN_CLEANUP_FUNCTION(function) \
     GEN_UNUSED \
     __attribute__((cleanup(function)))
 #define GEN_UNREACHABLE __builtin_unreachable()
+#define GEN_LIKELY(x) __builtin_expect(!!(x), 1)
+#define GEN_UNLIKELY(x) __builtin_expect(!!(x), 0)
 #define GEN_FORCE_INLINE \
     __attribute__((always_inline)) __attribute__((artificial)) inline
 #define GEN_FLAG_ENUM __attribute__((enum_extensibility(closed), flag_enum))
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_COMPRESS_H
+#define GEN_COMPRESS_H
+
+#include "gencommon.h"
+#include "genallocator.h"
+
+// How many earlier occurrences of a sequence are tried when looking for the
+// longest match. Higher depths trade speed for ratio, with a depth of 1
+// searching much like LZ4's fast mode.
+#ifndef GEN_COMPRESS_DEFAULT_DEPTH
+#define GEN_COMPRESS_DEFAULT_DEPTH 2
+#endif
+
+// The largest a block of `size` bytes can become once compressed.
+#define GEN_COMPRESS_BOUND(size) ((size) + (size) / 255 + 16)
+
+// The largest block which can be compressed.
+#define GEN_COMPRESS_MAXIMUM_SIZE 0x7E000000ull
+
+// Compresses blocks in the LZ4 block format, so that they can be read by any
+// LZ4 implementation. Blocks are independent of one another, but the match
+// finder's tables are kept between them to avoid reallocating.
+typedef struct {
+    gen_system_allocator_t allocator;
+    gen_size_t depth;
+
+    // The most recent position of each hashed sequence, and the distance back
+    // from each position to the previous one with the same hash. Positions
+    // carry on increasing across blocks so that the tables never need
+    // clearing between them.
+    gen_uint32_t* heads;
+    gen_uint16_t* chains;
+    gen_uint32_t base;
+} gen_compressor_t;
+
+// A `depth` of 0 selects `GEN_COMPRESS_DEFAULT_DEPTH`.
+gen_error_t* gen_compressor_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_size_t depth,
+        gen_compressor_t* const restrict out_compressor);
+
+gen_error_t* gen_compressor_destroy(
+        gen_compressor_t* const restrict compressor);
+
+// Compresses `size` bytes into `destination`, which cannot run short if it
+// holds `GEN_COMPRESS_BOUND(size)` bytes. Compressed blocks are not
+// self-delimiting, so their sizes need storing alongside them.
+gen_error_t* gen_compressor_compress(
+        gen_compressor_t* const restrict compressor,
+        const void* const restrict source, const gen_size_t size,
+        void* const restrict destination, const gen_size_t capacity,
+        gen_size_t* const restrict out_size);
+
+// Decompresses a whole block into `destination`. Every length and offset is
+// checked against both buffers, so malformed blocks fail with
+// `GEN_ERROR_BAD_CONTENT` rather than reading or writing out of bounds.
+gen_error_t* gen_decompress(
+        const void* const restrict source, const gen_size_t size,
+        void* const restrict destination, const gen_size_t capacity,
+        gen_size_t* const restrict out_size);
+
+#endif
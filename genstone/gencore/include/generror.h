@@ -37,6 +37,9 @@ typedef struct {
     gen_error_type_t type;
 } gen_failpoint_t;
 
+// Prefer `GEN_TRY` - failpoints save registers on every use and jumping out
+// of them skips `GEN_CLEANUP_FUNCTION` cleanups, which is why cleanups have to
+// be threaded through `GEN_CLEANUP_FAILPOINT`.
 #define GEN_FAILPOINT \
     do { \
         gen_failpoint_t _gen_failpoint; \
@@ -60,15 +63,22 @@ typedef struct {
         GEN_TYPEOF(v) variable; \
     } cleanup_##v = { &_gen_failpoint, v };
 
-#ifndef GEN_ERROR_MAXIMUM_CONTEXT_LENGTH
-#define GEN_ERROR_MAXIMUM_CONTEXT_LENGTH 2048
-#endif
+// Evaluates `expression` into the function's `error` variable and returns it
+// to the caller on failure. The error already carries the backtrace from where
+// it was raised and returning normally runs cleanups, so the success path
+// costs only a predicted branch.
+#define GEN_TRY(expression) \
+    do { \
+        error = (expression); \
+        if(GEN_UNLIKELY(error)) return error; \
+    } while(0)
 
 typedef struct {
     gen_error_type_t type;
 
     const char* line;
-    char context[GEN_ERROR_MAXIMUM_CONTEXT_LENGTH + 1];
+    // Owned by the raising thread and overwritten by its next error.
+    const char* context;
 
     gen_backtrace_t backtrace;
     gen_size_t backtrace_length;
@@ -83,4 +93,9 @@ gen_error_t* gen_error_attach_backtrace(
 
 GEN_NORETURN void gen_abort(void);
 
+// Frees the heap storage behind the calling thread's error contexts. Thread
+// locals have no destructors of their own, so backends call this as each
+// thread which has raised an error exits, however the thread was started.
+void gen_error_internal_release_context(void);
+
 #endif
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_EVENT_H
+#define GEN_EVENT_H
+
+#include "gencommon.h"
+
+typedef enum GEN_FLAG_ENUM {
+    GEN_EVENT_READINESS_READABLE = 1 << 0,
+    GEN_EVENT_READINESS_WRITABLE = 1 << 1,
+    GEN_EVENT_READINESS_HANGUP = 1 << 2,
+    GEN_EVENT_READINESS_ERROR = 1 << 3
+} gen_event_readiness_t;
+
+typedef struct gen_event_loop_t gen_event_loop_t;
+typedef struct gen_event_source_t gen_event_source_t;
+typedef struct gen_event_timer_t gen_event_timer_t;
+
+typedef gen_error_t* (*gen_event_source_handler_t)(
+        gen_event_loop_t*, gen_event_source_t*, gen_event_readiness_t, void*);
+typedef gen_error_t* (*gen_event_timer_handler_t)(
+        gen_event_loop_t*, gen_event_timer_t*, void*);
+
+// Sources and timers are owned by the caller and must outlive their
+// registration with a loop.
+struct gen_event_source_t {
+    gen_uintptr_t native;
+    gen_event_readiness_t interest;
+
+    gen_event_source_handler_t handler;
+    void* user_data;
+};
+
+struct gen_event_timer_t {
+    gen_event_timer_t* next;
+    gen_event_timer_t* previous;
+    gen_bool_t armed;
+    gen_size_t level;
+    gen_size_t slot;
+
+    gen_uint64_t deadline;
+
+    gen_event_timer_handler_t handler;
+    void* user_data;
+};
+
+#define GEN_EVENT_TIMER_WHEEL_LEVELS 8
+#define GEN_EVENT_TIMER_WHEEL_SLOT_BITS 6
+#define GEN_EVENT_TIMER_WHEEL_SLOTS (1 << GEN_EVENT_TIMER_WHEEL_SLOT_BITS)
+
+// A hierarchical timing wheel in units of milliseconds. Each level covers 64
+// times the span of the one below it and timers cascade down as their
+// deadline approaches, so arming and cancelling are constant time.
+typedef struct {
+    gen_uint64_t now;
+    gen_size_t count;
+
+    gen_uint64_t occupied[GEN_EVENT_TIMER_WHEEL_LEVELS];
+    gen_event_timer_t* slots
+            [GEN_EVENT_TIMER_WHEEL_LEVELS][GEN_EVENT_TIMER_WHEEL_SLOTS];
+} gen_event_timer_wheel_t;
+
+#define GEN_EVENT_LOOP_MAXIMUM_READY 64
+#define GEN_EVENT_LOOP_INFINITE GEN_UINT64_MAX
+
+typedef struct {
+    gen_event_source_t* source;
+    gen_event_readiness_t readiness;
+} gen_event_ready_t;
+
+struct gen_event_loop_t {
+    void* native;
+    gen_bool_t stopping;
+
+    gen_event_ready_t ready[GEN_EVENT_LOOP_MAXIMUM_READY];
+    gen_size_t ready_count;
+
+    gen_event_timer_wheel_t timers;
+};
+
+gen_error_t* gen_event_timer_wheel_create(
+        const gen_uint64_t now,
+        gen_event_timer_wheel_t* const restrict out_wheel);
+
+// Timers due at or before the wheel's current time fire on the next advance.
+gen_error_t* gen_event_timer_wheel_add(
+        gen_event_timer_wheel_t* const restrict wheel,
+        gen_event_timer_t* const restrict timer, const gen_uint64_t deadline);
+
+gen_error_t* gen_event_timer_wheel_cancel(
+        gen_event_timer_wheel_t* const restrict wheel,
+        gen_event_timer_t* const restrict timer);
+
+// Gets the time until the earliest slot which may hold a due timer. This can
+// be earlier than the earliest deadline when timers still need to cascade.
+gen_error_t* gen_event_timer_wheel_get_timeout(
+        const gen_event_timer_wheel_t* const restrict wheel,
+        gen_uint64_t* const restrict out_timeout);
+
+// Handlers may freely arm and cancel timers, including the one firing.
+gen_error_t* gen_event_timer_wheel_advance(
+        gen_event_timer_wheel_t* const restrict wheel, const gen_uint64_t now,
+        gen_event_loop_t* const restrict loop);
+
+gen_error_t* gen_event_loop_create(gen_event_loop_t* const restrict out_loop);
+
+gen_error_t* gen_event_loop_destroy(gen_event_loop_t* const restrict loop);
+
+gen_error_t* gen_event_loop_add(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source);
+
+// Applies changes to `source->interest`.
+gen_error_t* gen_event_loop_modify(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source);
+
+// Sources may be removed from within handlers - any readiness still pending
+// for them in the current iteration is dropped.
+gen_error_t* gen_event_loop_remove(
+        gen_event_loop_t* const restrict loop,
+        gen_event_source_t* const restrict source);
+
+gen_error_t* gen_event_loop_add_timer(
+        gen_event_loop_t* const restrict loop,
+        gen_event_timer_t* const restrict timer, const gen_uint64_t delay);
+
+gen_error_t* gen_event_loop_cancel_timer(
+        gen_event_loop_t* const restrict loop,
+        gen_event_timer_t* const restrict timer);
+
+// Interrupts a wait in progress on another thread. Safe to call from any
+// thread.
+gen_error_t* gen_event_loop_wake(gen_event_loop_t* const restrict loop);
+
+// Waits up to `timeout` milliseconds (or until the next timer is due) for
+// readiness, then dispatches ready sources and due timers. An error returned
+// from a handler stops dispatch and is returned.
+gen_error_t* gen_event_loop_run_once(
+        gen_event_loop_t* const restrict loop, const gen_uint64_t timeout);
+
+// Runs iterations until `gen_event_loop_stop` is called.
+gen_error_t* gen_event_loop_run(gen_event_loop_t* const restrict loop);
+
+gen_error_t* gen_event_loop_stop(gen_event_loop_t* const restrict loop);
+
+#endif
@@ -5,6 +5,7 @@
 #define GEN_FORMAT_H
 
 #include "gencommon.h"
+#include "genstringbuilder.h"
 
 typedef gen_size_t gen_format_count_t;
 
@@ -19,4 +20,12 @@ gen_error_t* gen_format_variadic_list(
         const gen_size_t limit, const char* const restrict format,
         gen_variadic_list_t list);
 
+// Appends to `builder`, growing it as output is produced. Failing to grow cuts
+// the output short and sets `out_exhausted` rather than raising an error, so
+// that errors can themselves be built this way.
+gen_error_t* gen_format_internal_builder_variadic_list(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict format, gen_variadic_list_t list,
+        gen_bool_t* const restrict out_exhausted);
+
 #endif
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_HASH_H
+#define GEN_HASH_H
+
+#include "gencommon.h"
+
+// Hashes are produced with the XXH3 64-bit algorithm, so digests match any
+// conforming XXH3 implementation for the same input and seed.
+
+#define GEN_HASH_SECRET_SIZE 192
+#define GEN_HASH_BUFFER_SIZE 256
+
+typedef struct {
+    gen_uint64_t accumulators[8];
+    gen_uint8_t secret[GEN_HASH_SECRET_SIZE];
+    gen_uint8_t buffer[GEN_HASH_BUFFER_SIZE];
+
+    gen_size_t buffered;
+    gen_size_t stripes;
+    gen_size_t length;
+    gen_uint64_t seed;
+} gen_hash_state_t;
+
+gen_error_t* gen_hash(
+        const void* const restrict data, const gen_size_t size,
+        const gen_uint64_t seed, gen_uint64_t* const restrict out_hash);
+
+gen_error_t* gen_hash_begin(
+        const gen_uint64_t seed, gen_hash_state_t* const restrict out_state);
+
+gen_error_t* gen_hash_update(
+        gen_hash_state_t* const restrict state, const void* const restrict data,
+        const gen_size_t size);
+
+gen_error_t* gen_hash_end(
+        const gen_hash_state_t* const restrict state,
+        gen_uint64_t* const restrict out_hash);
+
+// Unchecked one-shot hash for hot paths such as hashmap probing.
+gen_uint64_t gen_hash_internal_compute(
+        const void* const restrict data, const gen_size_t size,
+        const gen_uint64_t seed);
+
+#endif
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_HASHMAP_H
+#define GEN_HASHMAP_H
+
+#include "gencommon.h"
+#include "genallocator.h"
+
+// An open-addressing hashmap storing fixed-size keys and values inline.
+// Slots are tracked by a parallel array of control bytes which are probed a
+// group at a time.
+typedef struct {
+    gen_system_allocator_t allocator;
+
+    gen_size_t key_size;
+    gen_size_t value_size;
+    gen_size_t value_offset;
+    gen_size_t stride;
+
+    gen_size_t capacity;
+    gen_size_t length;
+    gen_size_t growth_left;
+
+    gen_uint8_t* controls;
+    gen_uint8_t* entries;
+} gen_hashmap_t;
+
+gen_error_t* gen_hashmap_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_size_t key_size, const gen_size_t value_size,
+        const gen_size_t initial_capacity,
+        gen_hashmap_t* const restrict out_hashmap);
+
+gen_error_t* gen_hashmap_destroy(gen_hashmap_t* const restrict hashmap);
+
+gen_error_t* gen_hashmap_reserve(
+        gen_hashmap_t* const restrict hashmap, const gen_size_t count);
+
+gen_error_t* gen_hashmap_clear(gen_hashmap_t* const restrict hashmap);
+
+// Inserts `key` or overwrites its existing value.
+gen_error_t* gen_hashmap_insert(
+        gen_hashmap_t* const restrict hashmap, const void* const restrict key,
+        const void* const restrict value);
+
+// `out_value` is set to `GEN_NULL` if `key` is not present.
+gen_error_t* gen_hashmap_get(
+        const gen_hashmap_t* const restrict hashmap,
+        const void* const restrict key, void** const restrict out_value);
+
+gen_error_t* gen_hashmap_remove(
+        gen_hashmap_t* const restrict hashmap, const void* const restrict key,
+        gen_bool_t* const restrict out_removed);
+
+// Starting from `*position == 0`, yields each entry in turn. `out_key` is set
+// to `GEN_NULL` once all entries have been visited.
+gen_error_t* gen_hashmap_next(
+        const gen_hashmap_t* const restrict hashmap,
+        gen_size_t* const restrict position,
+        const void** const restrict out_key, void** const restrict out_value);
+
+#endif
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_IO_H
+#define GEN_IO_H
+
+#include "gencommon.h"
+
+typedef enum GEN_FLAG_ENUM {
+    GEN_FILE_ACCESS_READ = 1 << 0,
+    GEN_FILE_ACCESS_WRITE = 1 << 1,
+    GEN_FILE_ACCESS_CREATE = 1 << 2,
+    GEN_FILE_ACCESS_APPEND = 1 << 3,
+    // Discards any existing contents when opening for writing.
+    GEN_FILE_ACCESS_TRUNCATE = 1 << 4
+} gen_file_access_t;
+
+typedef struct {
+    gen_file_access_t access;
+    gen_uintptr_t native;
+} gen_file_t;
+
+typedef enum {
+    GEN_FILE_STANDARD_INPUT,
+    GEN_FILE_STANDARD_OUTPUT,
+    GEN_FILE_STANDARD_ERROR
+} gen_file_standard_t;
+
+typedef enum {
+    GEN_FILE_ADVICE_NORMAL,
+    GEN_FILE_ADVICE_SEQUENTIAL,
+    GEN_FILE_ADVICE_RANDOM,
+    GEN_FILE_ADVICE_WILL_NEED,
+    GEN_FILE_ADVICE_DONT_NEED
+} gen_file_advice_t;
+
+// A view of a whole file's contents. Backends without a native mapping
+// facility read the file into memory instead, in which case writes only reach
+// the file on `gen_file_mapping_sync` or `gen_file_unmap`.
+typedef struct {
+    const gen_file_t* file;
+    gen_file_access_t access;
+
+    void* data;
+    gen_size_t size;
+} gen_file_mapping_t;
+
+gen_error_t* gen_file_open(
+        const char* const restrict path, const gen_file_access_t access,
+        gen_file_t* const restrict out_file);
+
+gen_error_t* gen_file_close(gen_file_t* const restrict file);
+
+// Standard handles are owned by the process and must not be closed.
+gen_error_t* gen_file_get_standard(
+        const gen_file_standard_t standard,
+        gen_file_t* const restrict out_file);
+
+// Reads up to `size` bytes from the current position. Fewer bytes may be read
+// than requested without reaching the end, which is signalled by reading 0.
+gen_error_t* gen_file_read(
+        const gen_file_t* const restrict file, void* const restrict buffer,
+        const gen_size_t size, gen_size_t* const restrict out_read);
+
+// Writes all of `size` bytes at the current position, or at the end if the
+// file was opened with `GEN_FILE_ACCESS_APPEND`.
+gen_error_t* gen_file_write(
+        const gen_file_t* const restrict file,
+        const void* const restrict buffer, const gen_size_t size);
+
+// Advice for the file as a whole, ignored where the file doesn't support it
+// (e.g. pipes).
+gen_error_t* gen_file_advise(
+        const gen_file_t* const restrict file, const gen_file_advice_t advice);
+
+gen_error_t* gen_file_get_size(
+        const gen_file_t* const restrict file,
+        gen_size_t* const restrict out_size);
+
+// Files opened with `GEN_FILE_ACCESS_APPEND` may only be mapped for reading.
+gen_error_t* gen_file_map(
+        const gen_file_t* const restrict file, const gen_file_access_t access,
+        gen_file_mapping_t* const restrict out_mapping);
+
+gen_error_t* gen_file_unmap(gen_file_mapping_t* const restrict mapping);
+
+gen_error_t* gen_file_mapping_advise(
+        const gen_file_mapping_t* const restrict mapping,
+        const gen_file_advice_t advice);
+
+gen_error_t* gen_file_mapping_sync(
+        const gen_file_mapping_t* const restrict mapping);
+
+#endif
@@ -5,6 +5,7 @@
 #define GEN_LOG_H
 
 #include "gencommon.h"
+#include "genstream.h"
 
 typedef enum {
     GEN_LOG_LEVEL_TRACE,
@@ -19,4 +20,25 @@ gen_error_t* gen_log(
         const gen_log_level_t level, const char* const restrict context,
         const char* const restrict format, ...);
 
+// Sends messages to `writer` rather than the terminal, or back to the terminal
+// if `GEN_NULL`. Messages of `GEN_LOG_LEVEL_ERROR` and above are flushed
+// immediately. The writer must stay valid until the target is changed again,
+// which also writes out any pending suppression counts.
+// Writers from `gen_stream_writer_create_compressed` store logs as LZ4 frames
+// readable by the `lz4` tool, at the cost of a smaller block for each flush.
+gen_error_t* gen_log_set_target(gen_stream_writer_t* const restrict writer);
+
+// Prefixes messages with the monotonic time in seconds.
+gen_error_t* gen_log_set_timestamps(const gen_bool_t enabled);
+
+// Limits each call site to `per_second` messages with bursts of up to `burst`,
+// or disables limiting if `per_second` is 0. Call sites are told apart by the
+// address of their format string, so suppressed messages are never formatted.
+// Consecutive identical messages are coalesced regardless. Suppressed and
+// repeated counts are reported at most once a second on the next message, and
+// otherwise when the target changes or the process exits. Errors and fatal
+// messages are exempt from both.
+gen_error_t* gen_log_set_rate_limit(
+        const gen_uint64_t per_second, const gen_uint64_t burst);
+
 #endif
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_METRICS_H
+#define GEN_METRICS_H
+
+#include "gencommon.h"
+#include "genlog.h"
+
+// These define the layout shared with readers so are not configurable.
+#define GEN_METRICS_MAGIC 0x5343495254454d47 // "GMETRICS"
+#define GEN_METRICS_MAXIMUM 256
+#define GEN_METRICS_NAME_LENGTH 48
+#define GEN_METRICS_SHARDS 16
+#define GEN_METRICS_SHARD_VALUES 4096
+
+// Histogram values are a count and sum followed by a bucket for 0 and one
+// per power of two, where bucket `n` holds values in `[2^(n-1), 2^n)`.
+#define GEN_METRICS_HISTOGRAM_BUCKETS 65
+#define GEN_METRICS_HISTOGRAM_VALUES (2 + GEN_METRICS_HISTOGRAM_BUCKETS)
+
+typedef enum {
+    // Summed across shards.
+    GEN_METRICS_KIND_COUNTER,
+    // Lives in the first shard only so that it can be set.
+    GEN_METRICS_KIND_GAUGE,
+    // Each value is summed across shards.
+    GEN_METRICS_KIND_HISTOGRAM
+} gen_metrics_kind_t;
+
+typedef struct {
+    char name[GEN_METRICS_NAME_LENGTH];
+    gen_uint64_t kind;
+    // The index of the metric's first value within each shard.
+    gen_uint64_t offset;
+} gen_metrics_descriptor_t;
+
+// The region readers map. `count` is published after the descriptor it
+// covers is written. Threads update their own shard so that they do not
+// contend on cache lines.
+typedef struct {
+    gen_uint64_t magic;
+    gen_uint64_t count;
+    gen_uint64_t used;
+
+    gen_metrics_descriptor_t descriptors[GEN_METRICS_MAXIMUM];
+    gen_uint64_t shards[GEN_METRICS_SHARDS][GEN_METRICS_SHARD_VALUES];
+} gen_metrics_region_t;
+
+typedef struct {
+    gen_metrics_kind_t kind;
+    gen_size_t offset;
+} gen_metric_t;
+
+// Creates the process' metrics region under `name` and registers the
+// built-in metrics - log lines by level, errors by type and allocator usage.
+// On Linux the region is a file in `/dev/shm` which can be read live.
+// Updates made before the region exists are dropped. `name` must be usable as
+// a file name, so may not be empty, `.` or `..` or contain `/`. A region whose
+// name is still in use, including one left behind by a process which did not
+// destroy it, is `GEN_ERROR_ALREADY_EXISTS` rather than being replaced.
+gen_error_t* gen_metrics_create(const char* const restrict name);
+
+// No other thread may be updating metrics while the region is destroyed.
+gen_error_t* gen_metrics_destroy(void);
+
+gen_error_t* gen_metrics_register(
+        const char* const restrict name, const gen_metrics_kind_t kind,
+        gen_metric_t* const restrict out_metric);
+
+// Updates are relaxed atomics on the calling thread's shard and cannot fail.
+
+void gen_metrics_add(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value);
+// Only valid for gauges.
+void gen_metrics_subtract(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value);
+// Only valid for gauges.
+void gen_metrics_set(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value);
+// Only valid for histograms.
+void gen_metrics_record(
+        const gen_metric_t* const restrict metric, const gen_uint64_t value);
+
+void gen_metrics_internal_count_log(const gen_log_level_t level);
+void gen_metrics_internal_count_error(const gen_error_type_t type);
+void gen_metrics_internal_count_allocation(const gen_size_t bytes);
+void gen_metrics_internal_count_free(const gen_size_t bytes);
+
+#endif
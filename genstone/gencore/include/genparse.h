@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_PARSE_H
+#define GEN_PARSE_H
+
+#include "gencommon.h"
+
+// Numbers are read from the start of `string` and no more than `length` bytes
+// are looked at, so the input needs no null terminator. `out_end` receives a
+// pointer one past the last byte consumed. If `out_end` is `GEN_NULL` the
+// whole of `string` must be a number. Whitespace is never skipped.
+//
+// Text which does not start with a number is `GEN_ERROR_BAD_CONTENT`, and a
+// number too large for the output type is `GEN_ERROR_OUT_OF_BOUNDS` with the
+// end still reported past it. Values are only written on success.
+
+gen_error_t* gen_parse_unsigned(
+        const char* const restrict string, const gen_size_t length,
+        gen_uint64_t* const restrict out_value,
+        const char** const restrict out_end);
+
+// As `gen_parse_unsigned` with an optional leading `+` or `-`.
+gen_error_t* gen_parse_signed(
+        const char* const restrict string, const gen_size_t length,
+        gen_ssize_t* const restrict out_value,
+        const char** const restrict out_end);
+
+// Parses a decimal number with an optional sign, fraction and exponent, or
+// `inf`, `infinity` or `nan` in any case, rounding to the nearest double with
+// ties to even. Values too small for a double become zero.
+gen_error_t* gen_parse_double(
+        const char* const restrict string, const gen_size_t length,
+        double* const restrict out_value, const char** const restrict out_end);
+
+#endif
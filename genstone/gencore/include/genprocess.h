@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_PROCESS_H
+#define GEN_PROCESS_H
+
+#include "gencommon.h"
+#include "genio.h"
+
+typedef gen_error_t* (*gen_process_proc_t)(void*);
+
+// `output` receives everything the process writes to its standard output and
+// standard error streams.
+typedef struct {
+    gen_uintptr_t native;
+    gen_file_t output;
+} gen_process_t;
+
+typedef struct {
+    // Whether the process was ended by a signal rather than exiting.
+    gen_bool_t signalled;
+    // The exit code, or the signal number if `signalled`.
+    gen_size_t code;
+} gen_process_status_t;
+
+// Runs `proc` in a copy of the current process. The child exits with 0 if
+// `proc` succeeds and 1 otherwise - reporting the error is left to `proc`.
+// Only available on platforms which can fork.
+gen_error_t* gen_process_fork(
+        const gen_process_proc_t proc, void* const restrict user_data,
+        gen_process_t* const restrict out_process);
+
+gen_error_t* gen_process_kill(const gen_process_t* const restrict process);
+
+// Waits for the process to end and releases it, including its output.
+gen_error_t* gen_process_wait(
+        gen_process_t* const restrict process,
+        gen_process_status_t* const restrict out_status);
+
+#endif
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_RECORDER_H
+#define GEN_RECORDER_H
+
+#include "gencommon.h"
+#include "genio.h"
+
+// The number of records kept per thread.
+#ifndef GEN_RECORDER_CAPACITY
+#define GEN_RECORDER_CAPACITY 32
+#endif
+
+// Records longer than this are truncated.
+#ifndef GEN_RECORDER_RECORD_LENGTH
+#define GEN_RECORDER_RECORD_LENGTH 256
+#endif
+
+// The flight recorder keeps the most recent log messages and errors raised
+// on each thread in a ring, regardless of where logging output is going. It
+// is dumped along with the current backtrace when `gen_abort` is called.
+
+// Copies `text` into the calling thread's ring, overwriting the oldest
+// record once it is full.
+void gen_recorder_record(
+        const char* const restrict text, const gen_size_t length);
+
+// Sets the file dumps are written to, or standard error if `GEN_NULL`. The
+// file must stay open until the output is changed again.
+gen_error_t* gen_recorder_set_output(const gen_file_t* const restrict file);
+
+// Writes the calling thread's records and backtrace to the output. This is
+// async-signal-safe where the platform allows it.
+void gen_recorder_dump(void);
+
+// Dumps the recorder when the process receives a fatal signal such as a
+// segmentation fault before letting the signal take its course. Where the
+// platform allows it the calling thread is given an alternate signal stack,
+// so that its stack overflowing can be reported too.
+gen_error_t* gen_recorder_install_signal_handlers(void);
+
+#endif
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_SORT_H
+#define GEN_SORT_H
+
+#include "gencommon.h"
+#include "genallocator.h"
+
+// Runs shorter than this are sorted by insertion.
+#ifndef GEN_SORT_INSERTION_THRESHOLD
+#define GEN_SORT_INSERTION_THRESHOLD 32
+#endif
+
+// Arrays are only split across threads while each thread gets at least this
+// many elements, below which starting threads costs more than it saves.
+#ifndef GEN_SORT_PARALLEL_MINIMUM
+#define GEN_SORT_PARALLEL_MINIMUM 65536
+#endif
+
+// Whether `a` orders strictly before `b`.
+typedef gen_bool_t (*gen_sort_less_t)(
+        const void* const restrict a, const void* const restrict b,
+        void* const restrict user_data);
+
+// Scratch space the size of the array is taken from `allocator` for the
+// duration of a sort. `thread_count` splits the work across that many threads
+// (0 meaning one per processor) where the array is large enough, falling back
+// to sorting on the calling thread on platforms without threads. Both sorts
+// are stable.
+
+// Sorts `count` records of `stride` bytes by an unsigned native-endian key of
+// `key_size` bytes, which may be 1, 2, 4 or 8, at `key_offset` into each
+// record. Arrays of bare keys are records whose `stride` is `key_size`.
+// Runs in linear time, passing over the array once per differing key byte.
+gen_error_t* gen_sort_radix(
+        void* const restrict records, const gen_size_t count,
+        const gen_size_t stride, const gen_size_t key_offset,
+        const gen_size_t key_size, const gen_size_t thread_count,
+        const gen_system_allocator_t* const restrict allocator);
+
+// Merge sort for elements which cannot be radix sorted. `less` is called
+// from several threads at once when sorting in parallel.
+gen_error_t* gen_sort_merge(
+        void* const restrict elements, const gen_size_t count,
+        const gen_size_t size, const gen_sort_less_t less,
+        void* const restrict user_data, const gen_size_t thread_count,
+        const gen_system_allocator_t* const restrict allocator);
+
+#endif
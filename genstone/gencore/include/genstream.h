@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_STREAM_H
+#define GEN_STREAM_H
+
+#include "gencommon.h"
+#include "genallocator.h"
+#include "gencompress.h"
+#include "genio.h"
+
+#ifndef GEN_STREAM_DEFAULT_CAPACITY
+#define GEN_STREAM_DEFAULT_CAPACITY (256 * 1024)
+#endif
+
+// The largest block size LZ4 frames allow.
+#define GEN_STREAM_MAXIMUM_COMPRESSED_CAPACITY (4 * 1024 * 1024)
+
+// Reads from a file in blocks of up to `capacity` bytes. Reads at least as
+// large as the buffer bypass it entirely.
+typedef struct {
+    gen_system_allocator_t allocator;
+    const gen_file_t* file;
+
+    gen_uint8_t* buffer;
+    gen_size_t capacity;
+    gen_size_t start;
+    gen_size_t end;
+
+    gen_bool_t exhausted;
+
+    // Set when reading LZ4 frames, which are decompressed a block at a time
+    // into `block` and handed on from there.
+    gen_bool_t decompressing;
+    gen_bool_t in_frame;
+    gen_uint8_t frame_flags;
+    gen_uint8_t* compressed;
+    gen_uint8_t* block;
+    gen_size_t block_capacity;
+    gen_size_t block_start;
+    gen_size_t block_end;
+} gen_stream_reader_t;
+
+// Coalesces writes into blocks of `capacity` bytes. Writes at least as large
+// as the buffer go straight to the file after flushing what is pending.
+typedef struct {
+    gen_system_allocator_t allocator;
+    const gen_file_t* file;
+
+    gen_uint8_t* buffer;
+    gen_size_t capacity;
+    gen_size_t length;
+
+    // Set when writing LZ4 frames, in which case each flush compresses what
+    // is pending into `compressed` and writes it out as a block.
+    gen_compressor_t compressor;
+    gen_uint8_t* compressed;
+} gen_stream_writer_t;
+
+// A `capacity` of 0 selects `GEN_STREAM_DEFAULT_CAPACITY`. `file` is advised
+// that it will be read sequentially.
+gen_error_t* gen_stream_reader_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_reader_t* const restrict out_reader);
+
+// As `gen_stream_reader_create` for files holding LZ4 frames, such as those
+// written by `gen_stream_writer_create_compressed` or the `lz4` tool, which
+// are read back decompressed. Frames with linked blocks or dictionaries are
+// not supported.
+gen_error_t* gen_stream_reader_create_decompressed(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_reader_t* const restrict out_reader);
+
+gen_error_t* gen_stream_reader_destroy(
+        gen_stream_reader_t* const restrict reader);
+
+// Reads up to `size` bytes, only reading less at the end of the file.
+gen_error_t* gen_stream_reader_read(
+        gen_stream_reader_t* const restrict reader,
+        void* const restrict buffer, const gen_size_t size,
+        gen_size_t* const restrict out_read);
+
+// Gets the next record ending in `delimiter` (which is not included). The
+// record points into the reader's buffer and is only valid until the next
+// call on the reader. A trailing record without a delimiter is still
+// returned, after which `out_record` is `GEN_NULL` at the end of the file.
+// Records longer than the buffer fail with `GEN_ERROR_TOO_LONG`.
+gen_error_t* gen_stream_reader_next_record(
+        gen_stream_reader_t* const restrict reader, const char delimiter,
+        const char** const restrict out_record,
+        gen_size_t* const restrict out_size);
+
+// A `capacity` of 0 selects `GEN_STREAM_DEFAULT_CAPACITY`.
+gen_error_t* gen_stream_writer_create(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_writer_t* const restrict out_writer);
+
+// As `gen_stream_writer_create`, compressing everything written into an LZ4
+// frame whose blocks are at most `capacity` bytes before compression. The
+// frame is ended when the writer is destroyed.
+gen_error_t* gen_stream_writer_create_compressed(
+        const gen_system_allocator_t* const restrict allocator,
+        const gen_file_t* const restrict file, const gen_size_t capacity,
+        gen_stream_writer_t* const restrict out_writer);
+
+// Flushes pending data before freeing the buffer.
+gen_error_t* gen_stream_writer_destroy(
+        gen_stream_writer_t* const restrict writer);
+
+gen_error_t* gen_stream_writer_write(
+        gen_stream_writer_t* const restrict writer,
+        const void* const restrict buffer, const gen_size_t size);
+
+gen_error_t* gen_stream_writer_flush(
+        gen_stream_writer_t* const restrict writer);
+
+#endif
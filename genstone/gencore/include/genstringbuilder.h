@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_STRING_BUILDER_H
+#define GEN_STRING_BUILDER_H
+
+#include "gencommon.h"
+#include "genallocator.h"
+
+#ifndef GEN_STRING_BUILDER_INLINE_CAPACITY
+#define GEN_STRING_BUILDER_INLINE_CAPACITY 256
+#endif
+
+#define GEN_STRING_BUILDER_AUTO \
+    GEN_CLEANUP_FUNCTION(gen_string_builder_internal_auto_destroy)
+
+// A null-terminated string which grows geometrically. Strings which fit in
+// `GEN_STRING_BUILDER_INLINE_CAPACITY` bytes are kept inline and never touch
+// the allocator, so builders are cheap to use as locals.
+typedef struct {
+    gen_system_allocator_t allocator;
+
+    // `GEN_NULL` while the string is stored inline. Keeping no pointer to the
+    // inline storage leaves the builder safe to copy around by value.
+    char* heap;
+    gen_size_t length;
+    // Excludes the null terminator.
+    gen_size_t capacity;
+
+    char storage[GEN_STRING_BUILDER_INLINE_CAPACITY + 1];
+} gen_string_builder_t;
+
+gen_error_t* gen_string_builder_create(
+        const gen_system_allocator_t* const restrict allocator,
+        gen_string_builder_t* const restrict out_builder);
+
+gen_error_t* gen_string_builder_destroy(
+        gen_string_builder_t* const restrict builder);
+
+// Ensures `additional` more bytes can be appended without reallocating.
+gen_error_t* gen_string_builder_reserve(
+        gen_string_builder_t* const restrict builder,
+        const gen_size_t additional);
+
+gen_error_t* gen_string_builder_append(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict string, const gen_size_t length);
+
+// Appends the output of `gen_format` in a single formatting pass, growing the
+// builder as the output is produced.
+gen_error_t* gen_string_builder_format(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict format, ...);
+
+gen_error_t* gen_string_builder_format_variadic_list(
+        gen_string_builder_t* const restrict builder,
+        const char* const restrict format, gen_variadic_list_t list);
+
+// Shortens the string to `length` bytes, keeping its storage.
+gen_error_t* gen_string_builder_truncate(
+        gen_string_builder_t* const restrict builder, const gen_size_t length);
+
+// The string stays valid until the builder is next modified.
+gen_error_t* gen_string_builder_get(
+        const gen_string_builder_t* const restrict builder,
+        const char** const restrict out_string,
+        gen_size_t* const restrict out_length);
+
+// Hands the string over to the caller, who frees it with the builder's
+// allocator, and leaves the builder empty. Heap storage is handed over as-is;
+// only inline strings are copied out.
+gen_error_t* gen_string_builder_take(
+        gen_string_builder_t* const restrict builder,
+        char** const restrict out_string,
+        gen_size_t* const restrict out_length);
+
+// Unchecked accessor for hot paths.
+char* gen_string_builder_internal_data(
+        gen_string_builder_t* const restrict builder);
+
+// Grows to hold at least `capacity` bytes without raising an error on failure,
+// so that it is usable while an error is being built.
+gen_bool_t gen_string_builder_internal_grow(
+        gen_string_builder_t* const restrict builder,
+        const gen_size_t capacity);
+
+void gen_string_builder_internal_auto_destroy(
+        gen_string_builder_t* const restrict builder);
+
+#endif
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_THREAD_H
+#define GEN_THREAD_H
+
+#include "gencommon.h"
+
+typedef gen_error_t* (*gen_thread_proc_t)(void*);
+
+typedef struct {
+    gen_uintptr_t native;
+} gen_thread_t;
+
+// Runs `proc` on a new thread. Only available on platforms with threads.
+gen_error_t* gen_thread_create(
+        const gen_thread_proc_t proc, void* const restrict user_data,
+        gen_thread_t* const restrict out_thread);
+
+// Waits for the thread to end and releases it. Errors belong to the thread
+// which raised them, so `out_failed` only reports whether `proc` failed -
+// reporting the error is left to `proc`.
+gen_error_t* gen_thread_join(
+        gen_thread_t* const restrict thread,
+        gen_bool_t* const restrict out_failed);
+
+// The number of processors available to run threads on. Platforms without
+// threads report 1.
+gen_error_t* gen_thread_get_processor_count(
+        gen_size_t* const restrict out_count);
+
+#endif
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#ifndef GEN_TIME_H
+#define GEN_TIME_H
+
+#include "gencommon.h"
+
+#define GEN_TIME_NANOSECONDS_PER_SECOND 1000000000ull
+
+// Nanoseconds from an arbitrary fixed point, unaffected by changes to the
+// system time.
+gen_error_t* gen_time_get_monotonic(gen_uint64_t* const restrict out_time);
+
+// A cheap, serialised timestamp counter for measuring short intervals. On
+// platforms without one the monotonic clock is used instead.
+gen_error_t* gen_time_get_cycles(gen_uint64_t* const restrict out_cycles);
+
+// The rate of the cycle counter in counts per second. This is calibrated
+// against the monotonic clock on first use, which takes a few milliseconds.
+gen_error_t* gen_time_get_cycle_frequency(
+        gen_uint64_t* const restrict out_frequency);
+
+gen_error_t* gen_time_cycles_to_nanoseconds(
+        const gen_uint64_t cycles, gen_uint64_t* const restrict out_time);
+
+#endif
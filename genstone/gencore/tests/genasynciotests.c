@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_TESTS_NAME "gencore"
+#define GEN_TESTS_UNIT "genasyncio"
+#include <gentests.h>
+
+#include <genasyncio.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define GEN_ASYNC_IO_TESTS_PATH "/tmp/gencore-async-io-tests"
+#define GEN_ASYNC_IO_TESTS_BLOCKS 4
+#define GEN_ASYNC_IO_TESTS_BLOCK_SIZE 4096
+
+static gen_uint8_t gen_async_io_tests_written
+        [GEN_ASYNC_IO_TESTS_BLOCKS][GEN_ASYNC_IO_TESTS_BLOCK_SIZE];
+static gen_uint8_t gen_async_io_tests_read
+        [GEN_ASYNC_IO_TESTS_BLOCKS + 1][GEN_ASYNC_IO_TESTS_BLOCK_SIZE];
+
+// Checks that each of `count` completions succeeded with the expected length
+// and that every request in the batch completed exactly once, in any order.
+static gen_error_t* gen_async_io_tests_internal_check(
+        const gen_async_io_completion_t* const restrict completions,
+        const gen_size_t count, gen_bool_t* const restrict seen,
+        const gen_size_t seen_length) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    for(gen_size_t i = 0; i < count; ++i) {
+        const gen_async_io_completion_t* const completion = &completions[i];
+        const gen_size_t index = (gen_size_t) completion->user_data;
+
+        GEN_TESTS_EXPECT(completion->failed, gen_false);
+        GEN_TESTS_EXPECT(index < seen_length, gen_true);
+        GEN_TESTS_EXPECT(seen[index], gen_false);
+
+        // The request past the end of the file reads nothing.
+        const gen_size_t expected =
+                index < GEN_ASYNC_IO_TESTS_BLOCKS ?
+                GEN_ASYNC_IO_TESTS_BLOCK_SIZE : 0;
+        GEN_TESTS_EXPECT(completion->transferred, expected);
+
+        seen[index] = gen_true;
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_async_io_tests_internal_run(
+        const gen_file_t* const restrict file) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_async_io_queue_t queue = {0};
+    error = gen_async_io_queue_create(8, &queue);
+    if(error) return error;
+
+    gen_async_io_request_t requests[GEN_ASYNC_IO_TESTS_BLOCKS + 1] = {0};
+    gen_async_io_completion_t completions[8] = {0};
+    gen_bool_t seen[GEN_ASYNC_IO_TESTS_BLOCKS + 1] = {0};
+    gen_size_t count = 0;
+
+    for(gen_size_t i = 0; i < GEN_ASYNC_IO_TESTS_BLOCKS; ++i) {
+        for(gen_size_t j = 0; j < GEN_ASYNC_IO_TESTS_BLOCK_SIZE; ++j) {
+            gen_async_io_tests_written[i][j] = (gen_uint8_t) (i * 31 + j);
+        }
+
+        requests[i] = (gen_async_io_request_t) {
+            GEN_ASYNC_IO_OPERATION_WRITE, file, gen_async_io_tests_written[i],
+            GEN_ASYNC_IO_TESTS_BLOCK_SIZE, i * GEN_ASYNC_IO_TESTS_BLOCK_SIZE,
+            (void*) i
+        };
+    }
+
+    error = gen_async_io_submit(&queue, requests, GEN_ASYNC_IO_TESTS_BLOCKS);
+    if(error) return error;
+
+    GEN_TESTS_EXPECT(queue.in_flight, GEN_ASYNC_IO_TESTS_BLOCKS);
+
+    error = gen_async_io_reap(
+            &queue, completions, GEN_ARRAY_LENGTH(completions),
+            GEN_ASYNC_IO_TESTS_BLOCKS, &count);
+    if(error) return error;
+
+    GEN_TESTS_EXPECT(count, GEN_ASYNC_IO_TESTS_BLOCKS);
+    error = gen_async_io_tests_internal_check(
+            completions, count, seen, GEN_ASYNC_IO_TESTS_BLOCKS);
+    if(error) return error;
+
+    // Writes may complete in any order, so the sync waits until they have.
+    const gen_async_io_request_t sync = {
+        GEN_ASYNC_IO_OPERATION_SYNC, file, GEN_NULL, 0, 0, GEN_NULL
+    };
+    error = gen_async_io_submit(&queue, &sync, 1);
+    if(error) return error;
+
+    error = gen_async_io_reap(&queue, completions, 1, 1, &count);
+    if(error) return error;
+
+    GEN_TESTS_EXPECT(count, 1);
+    GEN_TESTS_EXPECT(completions[0].failed, gen_false);
+
+    // The last read starts at the end of the file.
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(requests); ++i) {
+        requests[i] = (gen_async_io_request_t) {
+            GEN_ASYNC_IO_OPERATION_READ, file, gen_async_io_tests_read[i],
+            GEN_ASYNC_IO_TESTS_BLOCK_SIZE, i * GEN_ASYNC_IO_TESTS_BLOCK_SIZE,
+            (void*) i
+        };
+        seen[i] = gen_false;
+    }
+
+    error = gen_async_io_submit(
+            &queue, requests, GEN_ARRAY_LENGTH(requests));
+    if(error) return error;
+
+    // Reaping part of the batch leaves the rest in flight.
+    error = gen_async_io_reap(&queue, completions, 2, 2, &count);
+    if(error) return error;
+
+    GEN_TESTS_EXPECT(count, 2);
+    GEN_TESTS_EXPECT(queue.in_flight, GEN_ARRAY_LENGTH(requests) - 2);
+
+    error = gen_async_io_tests_internal_check(
+            completions, count, seen, GEN_ARRAY_LENGTH(seen));
+    if(error) return error;
+
+    // The queue is still in use until every completion has been reaped.
+    error = gen_async_io_queue_destroy(&queue);
+    GEN_TESTS_EXPECT(error && error->type == GEN_ERROR_IN_USE, gen_true);
+
+    gen_size_t remaining = queue.in_flight;
+    while(remaining) {
+        error = gen_async_io_reap(
+                &queue, completions, GEN_ARRAY_LENGTH(completions), 1,
+                &count);
+        if(error) return error;
+
+        error = gen_async_io_tests_internal_check(
+                completions, count, seen, GEN_ARRAY_LENGTH(seen));
+        if(error) return error;
+
+        remaining -= count;
+    }
+
+    GEN_TESTS_EXPECT(queue.in_flight, 0);
+
+    for(gen_size_t i = 0; i < GEN_ASYNC_IO_TESTS_BLOCKS; ++i) {
+        GEN_TESTS_EXPECT(seen[i], gen_true);
+        for(gen_size_t j = 0; j < GEN_ASYNC_IO_TESTS_BLOCK_SIZE; ++j) {
+            GEN_TESTS_EXPECT(
+                    gen_async_io_tests_read[i][j],
+                    gen_async_io_tests_written[i][j]);
+        }
+    }
+
+    // Oversized requests are refused before anything is submitted.
+    requests[0].size = (gen_size_t) GEN_UINT32_MAX + 1;
+    error = gen_async_io_submit(&queue, requests, 1);
+    GEN_TESTS_EXPECT(error && error->type == GEN_ERROR_TOO_LONG, gen_true);
+    GEN_TESTS_EXPECT(queue.in_flight, 0);
+
+    return gen_async_io_queue_destroy(&queue);
+}
+
+// Backends fall back to performing requests at submission when the native
+// facility is unavailable. On Linux that is forced by failing `io_uring_setup`
+// for the rest of this unit's process.
+static gen_error_t* gen_async_io_tests_internal_force_emulation(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+#ifdef __linux__
+    struct sock_filter filter[] = {
+        BPF_STMT(
+                BPF_LD | BPF_W | BPF_ABS,
+                __builtin_offsetof(struct seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_setup, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW)
+    };
+    const struct sock_fprog program = {
+        (unsigned short) GEN_ARRAY_LENGTH(filter), filter
+    };
+
+    if(prctl(PR_SET_NO_NEW_PRIVS, 1ul, 0ul, 0ul, 0ul) == -1 ||
+       prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) == -1) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OPERATION_FAILED, GEN_LINE_STRING,
+                "Failed to install the io_uring filter");
+    }
+
+    GEN_TESTS_EXPECT(syscall(__NR_io_uring_setup, 1, GEN_NULL), -1);
+    GEN_TESTS_EXPECT(errno, ENOSYS);
+#endif
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_main(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_file_t file = {0};
+    error = gen_file_open(
+            GEN_ASYNC_IO_TESTS_PATH,
+            GEN_FILE_ACCESS_READ | GEN_FILE_ACCESS_WRITE |
+            GEN_FILE_ACCESS_CREATE | GEN_FILE_ACCESS_TRUNCATE, &file);
+    if(error) return error;
+
+    error = gen_async_io_tests_internal_run(&file);
+    if(error) return error;
+
+    error = gen_async_io_tests_internal_force_emulation();
+    if(error) return error;
+
+    error = gen_async_io_tests_internal_run(&file);
+    if(error) return error;
+
+    return gen_file_close(&file);
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_TESTS_NAME "gencore"
+#define GEN_TESTS_UNIT "genhash"
+#include <gentests.h>
+
+#include <genhash.h>
+
+// Inputs are prefixes of the sample buffer used by `xxhsum`'s own sanity
+// checks, so the digests below come straight from the reference XXH3.
+#define GEN_HASH_TESTS_SAMPLE_SIZE 4099
+
+static const gen_uint64_t gen_hash_tests_seeds[] = {
+    0, 1, 0x9E3779B185EBCA8Dull
+};
+
+typedef struct {
+    gen_size_t length;
+    gen_uint64_t digests[GEN_ARRAY_LENGTH(gen_hash_tests_seeds)];
+} gen_hash_tests_vector_t;
+
+// Lengths either side of each of the 0-16, 17-128, 129-240 and long input
+// paths, and of the long path's stripe and block boundaries.
+static const gen_hash_tests_vector_t gen_hash_tests_vectors[] = {
+    {0, {
+        0x2D06800538D394C2ull, 0x4DC5B0CC826F6703ull, 0xA8A6B918B2F0364Aull
+    }},
+    {1, {
+        0xC44BDFF4074EECDBull, 0x5EAAC1F7B17EF730ull, 0x032BE332DD766EF8ull
+    }},
+    {3, {
+        0x54247382A8D6B94Dull, 0x03D22A2BEE351F17ull, 0x634B8990B4976373ull
+    }},
+    {4, {
+        0xE5DC74BC51848A51ull, 0x3CEC915201DC0A95ull, 0xAA2E7ECCB0C8F747ull
+    }},
+    {8, {
+        0x24CCC9ACAA9F65E4ull, 0x6EDD0A446C3329EDull, 0x8F973410999B8F6Bull
+    }},
+    {9, {
+        0x14D5001C15DD3F2Bull, 0x1E61BAC9667D1D90ull, 0xB3AE7333D9013F60ull
+    }},
+    {16, {
+        0x981B17D36C7498C9ull, 0x196DF22240867BF5ull, 0x663F29333B4DB6B1ull
+    }},
+    {17, {
+        0x796F5ACD3A60F862ull, 0x836117EF929839E9ull, 0xF3EC5067F4306DB3ull
+    }},
+    {64, {
+        0x9CB48487720EC49Dull, 0xB4D6E30DCB9C271Eull, 0x4FE8895DB9B8C077ull
+    }},
+    {128, {
+        0xFCFF24126754D861ull, 0x1F92C8F1A121BD98ull, 0x73FDE75280646649ull
+    }},
+    {129, {
+        0x98F1B0A679A2CA29ull, 0x19FE728FFCF4AB6Cull, 0x21FFFDBCA099C844ull
+    }},
+    {240, {
+        0x81C3C2B67F568CCFull, 0xEC8FA23C85C444D5ull, 0xCC0F58C27EF3D8EEull
+    }},
+    {241, {
+        0xC5A639ECD2030E5Eull, 0x10DA3DDD7528E20Full, 0xDDA9B0A161D4829Aull
+    }},
+    {1024, {
+        0xDD85C9B5C1109C5Cull, 0x60F78B42AF240C05ull, 0xEF368A8A2EBABAEFull
+    }},
+    {1025, {
+        0xD870C0FA13211C6Aull, 0xFE1CDB27EA8C2E20ull, 0x96792BCF9AF88519ull
+    }},
+    {2240, {
+        0x6E73A90539CF2948ull, 0x4FF7F8AD8BFFBE24ull, 0x757BA8487D1B5247ull
+    }},
+    {4099, {
+        0x318D235ABA648B01ull, 0x9930EF5328566C26ull, 0x7849F825702B5C2Full
+    }}
+};
+
+// Streamed input is fed in chunks which straddle the internal buffer both
+// ways, including empty updates.
+static const gen_size_t gen_hash_tests_chunks[] = {
+    0, 1, 7, 64, 255, 256, 1000
+};
+
+static gen_uint8_t gen_hash_tests_sample[GEN_HASH_TESTS_SAMPLE_SIZE];
+
+static gen_error_t* gen_hash_tests_internal_stream(
+        const gen_size_t length, const gen_uint64_t seed,
+        const gen_size_t chunk, gen_uint64_t* const restrict out_hash) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_hash_state_t state = {0};
+    error = gen_hash_begin(seed, &state);
+    if(error) return error;
+
+    // An empty chunk makes a single empty update before the whole input.
+    if(!chunk) {
+        error = gen_hash_update(&state, gen_hash_tests_sample, 0);
+        if(error) return error;
+    }
+
+    const gen_size_t step = chunk ? chunk : length;
+    for(gen_size_t offset = 0; offset < length; offset += step) {
+        error = gen_hash_update(
+                &state, gen_hash_tests_sample + offset,
+                GEN_MINIMUM(step, length - offset));
+        if(error) return error;
+    }
+
+    return gen_hash_end(&state, out_hash);
+}
+
+static gen_error_t* gen_main(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint64_t generator = 2654435761ull;
+    for(gen_size_t i = 0; i < GEN_HASH_TESTS_SAMPLE_SIZE; ++i) {
+        gen_hash_tests_sample[i] = (gen_uint8_t) (generator >> 56);
+        generator *= 11400714785074694797ull;
+    }
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(gen_hash_tests_vectors); ++i) {
+        const gen_hash_tests_vector_t* const vector =
+                &gen_hash_tests_vectors[i];
+
+        for(gen_size_t j = 0; j < GEN_ARRAY_LENGTH(gen_hash_tests_seeds); ++j) {
+            const gen_uint64_t seed = gen_hash_tests_seeds[j];
+            const gen_uint64_t expected = vector->digests[j];
+
+            gen_uint64_t hash = 0;
+            error = gen_hash(
+                    gen_hash_tests_sample, vector->length, seed, &hash);
+            if(error) return error;
+
+            GEN_TESTS_EXPECT(hash, expected);
+            GEN_TESTS_EXPECT(
+                    gen_hash_internal_compute(
+                            gen_hash_tests_sample, vector->length, seed),
+                    expected);
+
+            for(gen_size_t k = 0; k < GEN_ARRAY_LENGTH(gen_hash_tests_chunks);
+                ++k) {
+
+                error = gen_hash_tests_internal_stream(
+                        vector->length, seed, gen_hash_tests_chunks[k], &hash);
+                if(error) return error;
+
+                GEN_TESTS_EXPECT(hash, expected);
+            }
+        }
+    }
+
+    return GEN_NULL;
+}
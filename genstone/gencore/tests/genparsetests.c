@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#define GEN_TESTS_NAME "gencore"
+#define GEN_TESTS_UNIT "genparse"
+#include <gentests.h>
+
+#include <genformat.h>
+#include <genparse.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GEN_PARSE_TESTS_TEXT 64
+
+// Random values checked on top of the edge cases.
+#define GEN_PARSE_TESTS_CHECKS 100000
+
+static gen_uint64_t gen_parse_tests_internal_random(
+        gen_uint64_t* const restrict state) {
+
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+// Random bit patterns spread doubles evenly over exponents, rather than
+// clustering them around one magnitude as random fractions would.
+static double gen_parse_tests_internal_random_double(
+        gen_uint64_t* const restrict state) {
+
+    while(gen_true) {
+        const gen_uint64_t bits = gen_parse_tests_internal_random(state);
+        if(((bits >> 52) & 0x7FF) == 0x7FF) continue;
+
+        double value = 0.0;
+        __builtin_memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+}
+
+static gen_uint64_t gen_parse_tests_internal_bits(const double value) {
+    gen_uint64_t bits = 0;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+
+    return bits;
+}
+
+static gen_error_t* gen_parse_tests_internal_check_unsigned(
+        const gen_uint64_t value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char text[GEN_PARSE_TESTS_TEXT] = {0};
+    gen_size_t length = 0;
+    error = gen_format(text, &length, sizeof(text) - 1, "%uz", value);
+    if(error) return error;
+
+    gen_uint64_t parsed = 0;
+    error = gen_parse_unsigned(text, length, &parsed, GEN_NULL);
+    if(error) return error;
+
+    if(parsed != value) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "`%t` parsed back as %uz", text, parsed);
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_parse_tests_internal_check_signed(
+        const gen_ssize_t value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char text[GEN_PARSE_TESTS_TEXT] = {0};
+    gen_size_t length = 0;
+    error = gen_format(text, &length, sizeof(text) - 1, "%sz", value);
+    if(error) return error;
+
+    gen_ssize_t parsed = 0;
+    error = gen_parse_signed(text, length, &parsed, GEN_NULL);
+    if(error) return error;
+
+    if(parsed != value) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "`%t` parsed back as %sz", text, parsed);
+    }
+
+    return GEN_NULL;
+}
+
+// `strtod` is correctly rounded, so it stands in for the exact answer on text
+// which does not name a double exactly. Text it takes to infinity has to be
+// rejected as out of bounds instead.
+static gen_error_t* gen_parse_tests_internal_check_text(
+        const char* const restrict text) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const double expected = strtod(text, GEN_NULL);
+    const gen_bool_t overflows = __builtin_isinf(expected);
+
+    double parsed = 0.0;
+    gen_error_t* const result = gen_parse_double(
+            text, __builtin_strlen(text), &parsed, GEN_NULL);
+
+    if(overflows) {
+        if(result && result->type == GEN_ERROR_OUT_OF_BOUNDS) return GEN_NULL;
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "`%t` should have been out of bounds", text);
+    }
+
+    if(result) return result;
+
+    if(gen_parse_tests_internal_bits(parsed) !=
+       gen_parse_tests_internal_bits(expected)) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "`%t` parsed as bits %uz where `strtod` gave %uz", text,
+                gen_parse_tests_internal_bits(parsed),
+                gen_parse_tests_internal_bits(expected));
+    }
+
+    return GEN_NULL;
+}
+
+// `gen_format` has no floating point conversion, so doubles make the trip
+// through the shortest decimal which always names them exactly.
+static gen_error_t* gen_parse_tests_internal_check_double(
+        const double value) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    char text[GEN_PARSE_TESTS_TEXT] = {0};
+    const int length = snprintf(text, sizeof(text), "%.17g", value);
+
+    double parsed = 0.0;
+    error = gen_parse_double(text, (gen_size_t) length, &parsed, GEN_NULL);
+    if(error) return error;
+
+    if(gen_parse_tests_internal_bits(parsed) !=
+       gen_parse_tests_internal_bits(value)) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "`%t` parsed back as bits %uz rather than %uz", text,
+                gen_parse_tests_internal_bits(parsed),
+                gen_parse_tests_internal_bits(value));
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_parse_tests_internal_check_bounds(
+        const char* const restrict text, const gen_bool_t is_signed) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint64_t unsigned_value = 0;
+    gen_ssize_t signed_value = 0;
+    const gen_size_t length = __builtin_strlen(text);
+
+    gen_error_t* const result = is_signed ?
+            gen_parse_signed(text, length, &signed_value, GEN_NULL) :
+            gen_parse_unsigned(text, length, &unsigned_value, GEN_NULL);
+
+    if(!result || result->type != GEN_ERROR_OUT_OF_BOUNDS) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_DOES_NOT_MATCH, GEN_LINE_STRING,
+                "`%t` should have been out of bounds", text);
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_main(void) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // Every digit count and the values either side of each power of ten.
+    gen_uint64_t power = 1;
+    for(gen_size_t i = 0; i < 20; ++i, power *= 10) {
+        error = gen_parse_tests_internal_check_unsigned(power - 1);
+        if(error) return error;
+
+        error = gen_parse_tests_internal_check_unsigned(power);
+        if(error) return error;
+
+        if(power > GEN_SSIZE_MAX) continue;
+
+        error = gen_parse_tests_internal_check_signed(-(gen_ssize_t) power);
+        if(error) return error;
+    }
+
+    static const gen_uint64_t unsigned_edges[] = {
+        0, GEN_UINT64_MAX, GEN_UINT64_MAX - 1, GEN_SSIZE_MAX,
+        (gen_uint64_t) GEN_SSIZE_MAX + 1, 18446744073709551610ull
+    };
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(unsigned_edges); ++i) {
+        error = gen_parse_tests_internal_check_unsigned(unsigned_edges[i]);
+        if(error) return error;
+    }
+
+    static const gen_ssize_t signed_edges[] = {
+        0, -1, GEN_SSIZE_MAX, -GEN_SSIZE_MAX, -GEN_SSIZE_MAX - 1
+    };
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(signed_edges); ++i) {
+        error = gen_parse_tests_internal_check_signed(signed_edges[i]);
+        if(error) return error;
+    }
+
+    static const char* const unsigned_overflows[] = {
+        "18446744073709551616", "18446744073709551620",
+        "99999999999999999999", "100000000000000000000"
+    };
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(unsigned_overflows); ++i) {
+        error = gen_parse_tests_internal_check_bounds(
+                unsigned_overflows[i], gen_false);
+        if(error) return error;
+    }
+
+    static const char* const signed_overflows[] = {
+        "9223372036854775808", "-9223372036854775809",
+        "-18446744073709551616"
+    };
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(signed_overflows); ++i) {
+        error = gen_parse_tests_internal_check_bounds(
+                signed_overflows[i], gen_true);
+        if(error) return error;
+    }
+
+    // Halfway cases which round to even, mantissas longer than 19 digits,
+    // either side of the subnormal and overflow limits, and signed zero.
+    static const char* const double_edges[] = {
+        "9007199254740993", "9007199254740995", "9007199254740993.0000001",
+        "0.1000000000000000055511151231257827021181583404541015625",
+        "0.1000000000000000055511151231257827021181583404541015624",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "12345678901234567890", "123456789012345678901234567890e-10",
+        "4.9406564584124654e-324", "2.4703282292062328e-324",
+        "2.4703282292062327e-324", "2.2250738585072011e-308",
+        "2.2250738585072014e-308", "1e-400", "1.7976931348623157e308",
+        "1.7976931348623158e308", "1.7976931348623159e308", "1e309",
+        "-1e309", "0", "-0", "0e999999"
+    };
+
+    for(gen_size_t i = 0; i < GEN_ARRAY_LENGTH(double_edges); ++i) {
+        error = gen_parse_tests_internal_check_text(double_edges[i]);
+        if(error) return error;
+    }
+
+    gen_uint64_t state = 0x2545F4914F6CDD1Dull;
+    for(gen_size_t i = 0; i < GEN_PARSE_TESTS_CHECKS; ++i) {
+        const gen_uint64_t value = gen_parse_tests_internal_random(&state);
+        const gen_size_t shift = value % 64;
+
+        error = gen_parse_tests_internal_check_unsigned(value >> shift);
+        if(error) return error;
+
+        error = gen_parse_tests_internal_check_signed(
+                (gen_ssize_t) value >> shift);
+        if(error) return error;
+
+        const double number = gen_parse_tests_internal_random_double(&state);
+        error = gen_parse_tests_internal_check_double(number);
+        if(error) return error;
+
+        // Shorter text falls between doubles and longer text carries digits
+        // past the 19 that fit in the mantissa accumulator.
+        char text[GEN_PARSE_TESTS_TEXT] = {0};
+        snprintf(text, sizeof(text), "%.*g", (int) (value % 30) + 1, number);
+        error = gen_parse_tests_internal_check_text(text);
+        if(error) return error;
+    }
+
+    return GEN_NULL;
+}
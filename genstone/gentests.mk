@@ -19,6 +19,9 @@ gentests: $(GEN_TESTS_LIB)
 .PHONY: gentests
 test_gentests:
 
+.PHONY: bench_gentests
+bench_gentests:
+
 .PHONY: clean_gentests
 clean_gentests:
 	-$(RM) $(GEN_TESTS_OBJECTS)
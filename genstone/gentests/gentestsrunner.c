@@ -4,40 +4,603 @@
 #define GEN_TESTS_DISABLE
 #include "include/gentests.h"
 
+#include <genallocator.h>
+#include <genevent.h>
+#include <genio.h>
+#include <genprocess.h>
+#include <genstream.h>
+#include <gentime.h>
+
 gen_tests_unit_t gen_tests_list[GEN_TESTS_MAX] = {0};
 const char* gen_tests_name = GEN_TESTS_NAME;
 
-// We're quite lax about error reporting here because a test runner failure is
-// definitely a Genstone bug and not a test failure
-int main(void) {
+// Milliseconds a unit may run for before it is killed.
+#ifndef GEN_TESTS_DEFAULT_TIMEOUT
+#define GEN_TESTS_DEFAULT_TIMEOUT 60000
+#endif
+
+#define GEN_TESTS_OUTPUT_BLOCK 4096
+
+typedef enum {
+    GEN_TESTS_OUTCOME_PENDING,
+    GEN_TESTS_OUTCOME_PASSED,
+    GEN_TESTS_OUTCOME_FAILED,
+    GEN_TESTS_OUTCOME_TIMED_OUT,
+    GEN_TESTS_OUTCOME_CRASHED
+} gen_tests_outcome_t;
+
+typedef struct gen_tests_runner_t gen_tests_runner_t;
+
+typedef struct {
+    gen_tests_runner_t* runner;
+    const gen_tests_unit_t* unit;
+    gen_tests_outcome_t outcome;
+    gen_size_t signal;
+
+    gen_process_t process;
+    gen_event_source_t source;
+    gen_event_timer_t timer;
+    gen_bool_t timed_out;
+
+    gen_uint64_t started;
+    gen_uint64_t elapsed;
+
+    // Everything the unit logged, replayed once it is its turn to report.
+    gen_uint8_t* output;
+    gen_size_t output_length;
+    gen_size_t output_capacity;
+} gen_tests_job_t;
+
+struct gen_tests_runner_t {
+    gen_system_allocator_t allocator;
+    gen_event_loop_t loop;
+    gen_stream_writer_t* writer;
+
+    gen_tests_job_t* jobs;
+    gen_size_t length;
+    gen_size_t running;
+    gen_size_t finished;
+};
+
+typedef struct {
+    gen_size_t passed;
+    gen_size_t failed;
+    gen_size_t timed_out;
+    gen_size_t crashed;
+} gen_tests_summary_t;
+
+static gen_bool_t gen_tests_internal_equal(
+        const char* const restrict a, const char* const restrict b,
+        const gen_size_t b_length) {
+
+    gen_size_t i = 0;
+    for(; i < b_length && a[i] && a[i] == b[i]; ++i);
+
+    return i == b_length && !a[i];
+}
+
+static gen_error_t* gen_tests_internal_parse(
+        const char* const restrict string, gen_uint64_t* const restrict out) {
+
     gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
     GEN_TOOLING_AUTO gen_error_t* error;
 
-    gen_size_t len = 0;
-    for(; gen_tests_list[len].present && len < GEN_TESTS_MAX; ++len);
+    *out = 0;
+    for(gen_size_t i = 0; string[i]; ++i) {
+        if(string[i] < '0' || string[i] > '9') {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                    "`%t` was not a number", string);
+        }
 
-    gen_bool_t had_failure = gen_false;
-    for(gen_size_t i = 0; i < len; ++i) {
-        gen_log(
-                GEN_LOG_LEVEL_INFO, gen_tests_name,
-                "Testing %t... [%uz/%uz]", gen_tests_list[i].name, i + 1, len);
-        error = gen_tests_list[i].proc();
-        if(error) {
-            gen_log(GEN_LOG_LEVEL_ERROR, gen_tests_name, "%e", error);
-            had_failure = gen_true;
-            gen_log(
+        *out = *out * 10 + (gen_uint64_t) (string[i] - '0');
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_tests_internal_get_milliseconds(
+        gen_uint64_t* const restrict out_milliseconds) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_uint64_t now = 0;
+    error = gen_time_get_monotonic(&now);
+    if(error) return error;
+
+    *out_milliseconds = now / (GEN_TIME_NANOSECONDS_PER_SECOND / 1000);
+
+    return GEN_NULL;
+}
+
+static gen_bool_t gen_tests_internal_has_budget(
+        const gen_tests_budget_t* const restrict budget) {
+
+    return budget->time || budget->allocations || budget->peak_bytes;
+}
+
+// Runs the unit and checks its usage against its budget, logging the unit's
+// error if it failed.
+static gen_error_t* gen_tests_internal_run_unit(
+        const gen_tests_unit_t* const restrict unit) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_tests_budget_t* const budget = &unit->budget;
+
+    error = gen_allocator_reset_statistics();
+    if(error) return error;
+
+    // The runner's own allocations are inherited by forked units.
+    gen_allocator_statistics_t statistics = {0};
+    error = gen_allocator_get_statistics(&statistics);
+    if(error) return error;
+
+    const gen_size_t baseline = statistics.bytes;
+
+    gen_uint64_t start = 0;
+    error = gen_tests_internal_get_milliseconds(&start);
+    if(error) return error;
+
+    error = unit->proc();
+    if(error) {
+        gen_log(GEN_LOG_LEVEL_ERROR, gen_tests_name, "%e", error);
+        return error;
+    }
+
+    gen_uint64_t end = 0;
+    error = gen_tests_internal_get_milliseconds(&end);
+    if(error) return error;
+
+    error = gen_allocator_get_statistics(&statistics);
+    if(error) return error;
+
+    if(!gen_tests_internal_has_budget(budget)) return GEN_NULL;
+
+    const gen_uint64_t time = end - start;
+    const gen_size_t peak_bytes = statistics.peak_bytes - baseline;
+
+    gen_log(
+            GEN_LOG_LEVEL_INFO, gen_tests_name,
+            "Used %ul/%ul ms, %uz/%uz allocations, %uz/%uz peak bytes",
+            time, budget->time, statistics.allocations, budget->allocations,
+            peak_bytes, budget->peak_bytes);
+
+    if(budget->time && time > budget->time) {
+        error = gen_error_attach_backtrace(
+                GEN_ERROR_BAD_TIMING, GEN_LINE_STRING,
+                "Unit took %ul ms which exceeds its budget of %ul ms",
+                time, budget->time);
+    }
+    else if(budget->allocations &&
+            statistics.allocations > budget->allocations) {
+
+        error = gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_SPACE, GEN_LINE_STRING,
+                "Unit made %uz allocations which exceeds its budget of %uz",
+                statistics.allocations, budget->allocations);
+    }
+    else if(budget->peak_bytes && peak_bytes > budget->peak_bytes) {
+        error = gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_SPACE, GEN_LINE_STRING,
+                "Unit peaked at %uz bytes which exceeds its budget of %uz",
+                peak_bytes, budget->peak_bytes);
+    }
+
+    if(error) gen_log(GEN_LOG_LEVEL_ERROR, gen_tests_name, "%e", error);
+
+    return error;
+}
+
+// Runs in the forked child, where output goes straight to the pipe.
+static gen_error_t* gen_tests_internal_child(void* user_data) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    const gen_tests_job_t* const job = user_data;
+
+    error = gen_log_set_target(GEN_NULL);
+    if(error) return error;
+
+    return gen_tests_internal_run_unit(job->unit);
+}
+
+static gen_error_t* gen_tests_internal_finish(
+        gen_tests_job_t* const restrict job) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_tests_runner_t* const runner = job->runner;
+
+    error = gen_event_loop_remove(&runner->loop, &job->source);
+    if(error) return error;
+
+    if(!job->timed_out) {
+        error = gen_event_loop_cancel_timer(&runner->loop, &job->timer);
+        if(error) return error;
+    }
+
+    gen_process_status_t status = {0};
+    error = gen_process_wait(&job->process, &status);
+    if(error) return error;
+
+    gen_uint64_t now = 0;
+    error = gen_tests_internal_get_milliseconds(&now);
+    if(error) return error;
+
+    job->elapsed = now - job->started;
+
+    if(job->timed_out) job->outcome = GEN_TESTS_OUTCOME_TIMED_OUT;
+    else if(status.signalled) {
+        job->outcome = GEN_TESTS_OUTCOME_CRASHED;
+        job->signal = status.code;
+    }
+    else if(status.code) job->outcome = GEN_TESTS_OUTCOME_FAILED;
+    else job->outcome = GEN_TESTS_OUTCOME_PASSED;
+
+    --runner->running;
+    ++runner->finished;
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_tests_internal_handle_output(
+        GEN_UNUSED gen_event_loop_t* loop,
+        GEN_UNUSED gen_event_source_t* source,
+        GEN_UNUSED gen_event_readiness_t readiness, void* user_data) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_tests_job_t* const job = user_data;
+    const gen_system_allocator_t* const allocator = &job->runner->allocator;
+
+    if(job->output_capacity - job->output_length < GEN_TESTS_OUTPUT_BLOCK) {
+        const gen_size_t capacity =
+                job->output_capacity * 2 + GEN_TESTS_OUTPUT_BLOCK;
+        gen_uint8_t* const output =
+                allocator->realloc(job->output, capacity);
+        if(!output) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                    "Failed to grow output buffer for `%t`", job->unit->name);
+        }
+
+        job->output = output;
+        job->output_capacity = capacity;
+    }
+
+    gen_size_t read = 0;
+    error = gen_file_read(
+            &job->process.output, job->output + job->output_length,
+            job->output_capacity - job->output_length, &read);
+    if(error) return error;
+
+    job->output_length += read;
+
+    // The pipe only reaches the end once the child is gone.
+    if(!read) return gen_tests_internal_finish(job);
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_tests_internal_handle_timeout(
+        GEN_UNUSED gen_event_loop_t* loop, GEN_UNUSED gen_event_timer_t* timer,
+        void* user_data) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_tests_job_t* const job = user_data;
+
+    // Reaping happens once the pipe reports the end of the output.
+    job->timed_out = gen_true;
+
+    return gen_process_kill(&job->process);
+}
+
+static gen_error_t* gen_tests_internal_start(
+        gen_tests_runner_t* const restrict runner,
+        gen_tests_job_t* const restrict job, const gen_uint64_t timeout) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // Pending log output would otherwise be duplicated into the child.
+    error = gen_stream_writer_flush(runner->writer);
+    if(error) return error;
+
+    error = gen_tests_internal_get_milliseconds(&job->started);
+    if(error) return error;
+
+    error = gen_process_fork(
+            gen_tests_internal_child, job, &job->process);
+    if(error) return error;
+
+    job->source = (gen_event_source_t) {
+        job->process.output.native, GEN_EVENT_READINESS_READABLE,
+        gen_tests_internal_handle_output, job
+    };
+    error = gen_event_loop_add(&runner->loop, &job->source);
+    if(error) return error;
+
+    job->timer = (gen_event_timer_t) {0};
+    job->timer.handler = gen_tests_internal_handle_timeout;
+    job->timer.user_data = job;
+    error = gen_event_loop_add_timer(&runner->loop, &job->timer, timeout);
+    if(error) return error;
+
+    ++runner->running;
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_tests_internal_report(
+        gen_tests_runner_t* const restrict runner,
+        gen_tests_job_t* const restrict job, const gen_size_t index,
+        gen_tests_summary_t* const restrict summary) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_log(
+            GEN_LOG_LEVEL_INFO, gen_tests_name, "Testing %t... [%uz/%uz]",
+            job->unit->name, index + 1, runner->length);
+    if(error) return error;
+
+    error = gen_stream_writer_write(
+            runner->writer, job->output, job->output_length);
+    if(error) return error;
+
+    runner->allocator.free(job->output);
+    job->output = GEN_NULL;
+
+    switch(job->outcome) {
+        case GEN_TESTS_OUTCOME_PENDING: break;
+        case GEN_TESTS_OUTCOME_PASSED: {
+            ++summary->passed;
+            return gen_log(
+                    GEN_LOG_LEVEL_INFO, gen_tests_name, "Passed! (%ul ms)",
+                    job->elapsed);
+        }
+        case GEN_TESTS_OUTCOME_FAILED: {
+            ++summary->failed;
+            return gen_log(GEN_LOG_LEVEL_ERROR, gen_tests_name, "Failed!");
+        }
+        case GEN_TESTS_OUTCOME_TIMED_OUT: {
+            ++summary->timed_out;
+            return gen_log(
+                    GEN_LOG_LEVEL_ERROR, gen_tests_name,
+                    "Timed out after %ul ms", job->elapsed);
+        }
+        case GEN_TESTS_OUTCOME_CRASHED: {
+            ++summary->crashed;
+            return gen_log(
                     GEN_LOG_LEVEL_ERROR, gen_tests_name,
-                    "Failed!", i + 1, len);
+                    "Crashed with signal %uz", job->signal);
+        }
+    }
+
+    return GEN_NULL;
+}
+
+// Runs up to `jobs` units at once, each in its own process. Results are
+// reported in registration order regardless of the order units finish in.
+static gen_error_t* gen_tests_internal_run_parallel(
+        gen_tests_runner_t* const restrict runner, const gen_uint64_t jobs,
+        const gen_uint64_t timeout,
+        gen_tests_summary_t* const restrict summary) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_size_t started = 0;
+    gen_size_t reported = 0;
+    while(reported < runner->length) {
+        while(runner->running < jobs && started < runner->length) {
+            error = gen_tests_internal_start(
+                    runner, &runner->jobs[started++], timeout);
+            if(error) return error;
+        }
+
+        error = gen_event_loop_run_once(
+                &runner->loop, GEN_EVENT_LOOP_INFINITE);
+        if(error) return error;
+
+        for(; reported < runner->length; ++reported) {
+            gen_tests_job_t* const job = &runner->jobs[reported];
+            if(job->outcome == GEN_TESTS_OUTCOME_PENDING) break;
+
+            error = gen_tests_internal_report(runner, job, reported, summary);
+            if(error) return error;
+        }
+    }
+
+    return GEN_NULL;
+}
+
+// Fallback for platforms without processes - units share the runner's
+// process and timeouts cannot be enforced.
+static gen_error_t* gen_tests_internal_run_serial(
+        gen_tests_runner_t* const restrict runner,
+        gen_tests_summary_t* const restrict summary) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    for(gen_size_t i = 0; i < runner->length; ++i) {
+        const gen_tests_unit_t* const unit = runner->jobs[i].unit;
+
+        error = gen_log(
+                GEN_LOG_LEVEL_INFO, gen_tests_name, "Testing %t... [%uz/%uz]",
+                unit->name, i + 1, runner->length);
+        if(error) return error;
+
+        error = gen_tests_internal_run_unit(unit);
+        if(error) {
+            ++summary->failed;
+            gen_log(GEN_LOG_LEVEL_ERROR, gen_tests_name, "Failed!");
+        }
+        else {
+            ++summary->passed;
+            gen_log(GEN_LOG_LEVEL_INFO, gen_tests_name, "Passed!");
+        }
+    }
+
+    return GEN_NULL;
+}
+
+static gen_error_t* gen_tests_internal_main(
+        const gen_size_t argc, const char* const* const argv,
+        gen_bool_t* const restrict out_failed) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    // Progress for every unit is logged from the same call sites, so rate
+    // limiting would drop the lines saying which unit a result belongs to.
+    error = gen_log_set_rate_limit(0, 0);
+    if(error) return error;
+
+    gen_uint64_t start = 0;
+    error = gen_tests_internal_get_milliseconds(&start);
+    if(error) return error;
+
+    gen_uint64_t jobs = 1;
+    gen_uint64_t timeout = GEN_TESTS_DEFAULT_TIMEOUT;
+
+    for(gen_size_t i = 1; i < argc; i += 2) {
+        const char* const option = argv[i];
+        if(i + 1 >= argc) {
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "Option `%t` was missing a value", option);
+        }
+
+        const char* const value = argv[i + 1];
+
+        if(gen_tests_internal_equal(option, "--jobs", 6)) {
+            error = gen_tests_internal_parse(value, &jobs);
+            if(error) return error;
+        }
+        else if(gen_tests_internal_equal(option, "--timeout", 9)) {
+            error = gen_tests_internal_parse(value, &timeout);
+            if(error) return error;
         }
         else {
-            gen_log(GEN_LOG_LEVEL_INFO, gen_tests_name, "Passed!", i + 1, len);
+            return gen_error_attach_backtrace(
+                    GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                    "Unknown option `%t`", option);
         }
     }
-    if(had_failure) {
+
+    if(!jobs) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "`--jobs` must be at least 1");
+    }
+
+    gen_tests_runner_t runner = {0};
+    gen_tests_summary_t summary = {0};
+
+    error = gen_get_system_allocator(&runner.allocator);
+    if(error) return error;
+
+    for(; gen_tests_list[runner.length].present &&
+          runner.length < GEN_TESTS_MAX; ++runner.length);
+
+    runner.jobs = runner.allocator.calloc(
+            GEN_MAXIMUM(runner.length, 1), sizeof(gen_tests_job_t));
+    if(!runner.jobs) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_OUT_OF_MEMORY, GEN_LINE_STRING,
+                "Failed to allocate test jobs");
+    }
+
+    for(gen_size_t i = 0; i < runner.length; ++i) {
+        runner.jobs[i].runner = &runner;
+        runner.jobs[i].unit = &gen_tests_list[i];
+    }
+
+    // Output from the runner and replayed unit output share one stream so
+    // they stay in order.
+    gen_file_t output_file = {0};
+    error = gen_file_get_standard(GEN_FILE_STANDARD_OUTPUT, &output_file);
+    if(error) return error;
+
+    gen_stream_writer_t writer = {0};
+    error = gen_stream_writer_create(
+            &runner.allocator, &output_file, 0, &writer);
+    if(error) return error;
+
+    runner.writer = &writer;
+
+    error = gen_log_set_target(&writer);
+    if(error) return error;
+
+    error = gen_event_loop_create(&runner.loop);
+    if(error && error->type != GEN_ERROR_NOT_IMPLEMENTED) return error;
+
+    if(error) {
+        error = gen_tests_internal_run_serial(&runner, &summary);
+        if(error) return error;
+    }
+    else {
+        error = gen_tests_internal_run_parallel(
+                &runner, jobs, timeout, &summary);
+        if(error) return error;
+
+        error = gen_event_loop_destroy(&runner.loop);
+        if(error) return error;
+    }
+
+    gen_uint64_t end = 0;
+    error = gen_tests_internal_get_milliseconds(&end);
+    if(error) return error;
+
+    gen_log(
+            GEN_LOG_LEVEL_INFO, gen_tests_name,
+            "%uz passed, %uz failed, %uz timed out, %uz crashed in %ul ms",
+            summary.passed, summary.failed, summary.timed_out,
+            summary.crashed, end - start);
+
+    *out_failed = summary.failed || summary.timed_out || summary.crashed;
+
+    // Logged before the target is reset so that the verdict is flushed.
+    if(*out_failed) {
         gen_log(GEN_LOG_LEVEL_FATAL, gen_tests_name, "Test suite failed");
-        gen_abort();
     }
     else {
         gen_log(GEN_LOG_LEVEL_INFO, gen_tests_name, "All units passing");
     }
+
+    error = gen_log_set_target(GEN_NULL);
+    if(error) return error;
+
+    error = gen_stream_writer_destroy(&writer);
+    if(error) return error;
+
+    runner.allocator.free(runner.jobs);
+
+    return GEN_NULL;
+}
+
+// We're quite lax about error reporting here because a test runner failure is
+// definitely a Genstone bug and not a test failure
+int main(int argc, char** argv) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    gen_bool_t failed = gen_false;
+    error = gen_tests_internal_main(
+            (gen_size_t) argc, (const char* const*) argv, &failed);
+    if(error) {
+        gen_log(GEN_LOG_LEVEL_FATAL, gen_tests_name, "%e", error);
+        gen_abort();
+    }
+
+    if(failed) gen_abort();
 }
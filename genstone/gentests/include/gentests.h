@@ -17,12 +17,33 @@ typedef gen_error_t* (*gen_main_t)(void);
 #define GEN_TESTS_UNIT "unnamed-unit"
 #endif
 
+// Units may declare budgets which fail them when exceeded. A budget of 0 is
+// unlimited. Only allocations made through `gen_get_system_allocator` count.
+#ifndef GEN_TESTS_BUDGET_TIME
+#define GEN_TESTS_BUDGET_TIME 0 // Milliseconds
+#endif
+
+#ifndef GEN_TESTS_BUDGET_ALLOCATIONS
+#define GEN_TESTS_BUDGET_ALLOCATIONS 0
+#endif
+
+#ifndef GEN_TESTS_BUDGET_PEAK_BYTES
+#define GEN_TESTS_BUDGET_PEAK_BYTES 0
+#endif
+
 #define GEN_TESTS_MAX 512
 
+typedef struct {
+    gen_uint64_t time;
+    gen_size_t allocations;
+    gen_size_t peak_bytes;
+} gen_tests_budget_t;
+
 typedef struct {
     gen_bool_t present;
     const char* name;
     gen_main_t proc;
+    gen_tests_budget_t budget;
 } gen_tests_unit_t;
 
 extern gen_tests_unit_t gen_tests_list[GEN_TESTS_MAX];
@@ -60,7 +81,13 @@ GEN_INITIALIZER static void gen_tests_internal_register_test(void) {
     }
 
     gen_tests_list[i] = (gen_tests_unit_t) {
-                            gen_true, GEN_TESTS_UNIT, gen_main };
+                            gen_true, GEN_TESTS_UNIT, gen_main,
+                            {
+                                GEN_TESTS_BUDGET_TIME,
+                                GEN_TESTS_BUDGET_ALLOCATIONS,
+                                GEN_TESTS_BUDGET_PEAK_BYTES
+                            }
+                        };
 }
 #endif
 
@@ -0,0 +1,39 @@
+GEN_TOOLS_CFLAGS = $(GEN_CORE_CFLAGS) $(GENSTONE_DIAGNOSTIC_CFLAGS)
+GEN_TOOLS_LFLAGS = $(GEN_CORE_LFLAGS)
+GEN_TOOLS_LIBDIRS = $(GEN_CORE_LIBDIRS)
+
+GEN_TOOLS_BIN = $(GENSTONE_DIR)/bin
+
+GEN_METRICS_READER_SOURCES = \
+	$(GENSTONE_DIR)/genstone/gentools/genmetricsreader.c
+GEN_METRICS_READER_OBJECTS = \
+	$(GEN_METRICS_READER_SOURCES:.c=$(OBJECT_SUFFIX))
+
+GEN_METRICS_READER = $(GEN_TOOLS_BIN)/genmetricsreader$(EXECUTABLE_SUFFIX)
+
+$(GEN_METRICS_READER): CFLAGS = $(GEN_TOOLS_CFLAGS)
+$(GEN_METRICS_READER): LFLAGS = $(GEN_TOOLS_LFLAGS)
+$(GEN_METRICS_READER): LIBDIRS = $(GEN_TOOLS_LIBDIRS)
+$(GEN_METRICS_READER): $(GEN_METRICS_READER_OBJECTS) $(GEN_CORE_LIB) \
+						| $(GEN_TOOLS_BIN)
+
+$(GEN_TOOLS_BIN):
+	-$(MKDIR) $@
+
+.PHONY: genmetricsreader
+genmetricsreader: $(GEN_METRICS_READER)
+
+.PHONY: gentools
+gentools: genmetricsreader
+
+.PHONY: test_gentools
+test_gentools:
+
+.PHONY: bench_gentools
+bench_gentools:
+
+.PHONY: clean_gentools
+clean_gentools:
+	-$(RM) $(GEN_METRICS_READER_OBJECTS)
+	-$(RM) $(GEN_METRICS_READER)
+	-$(RMDIR) $(GEN_TOOLS_BIN)
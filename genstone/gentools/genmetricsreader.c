@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2023 Emily "TTG" Banerjee <prs.ttg+genstone@pm.me>
+
+#include <gencommon.h>
+#include <genformat.h>
+#include <genio.h>
+#include <genlog.h>
+#include <genmetrics.h>
+#include <genstream.h>
+
+// Gets the upper bound of the bucket containing the given quantile.
+static gen_uint64_t gen_metrics_reader_internal_quantile(
+        const gen_uint64_t* const restrict buckets, const gen_uint64_t count,
+        const gen_uint64_t percent) {
+
+    const gen_uint64_t rank = (count * percent + 99) / 100;
+
+    gen_uint64_t seen = 0;
+    for(gen_size_t i = 0; i < GEN_METRICS_HISTOGRAM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if(seen >= rank && seen) {
+            if(!i) return 0;
+            return i == 64 ? GEN_UINT64_MAX : (1ull << i) - 1;
+        }
+    }
+
+    return 0;
+}
+
+static gen_error_t* gen_metrics_reader_internal_write_metric(
+        gen_stream_writer_t* const restrict writer,
+        const gen_metrics_region_t* const restrict region,
+        const gen_metrics_descriptor_t* const restrict descriptor) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(descriptor->kind > GEN_METRICS_KIND_HISTOGRAM) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                "Metric `%t` has an unknown kind", descriptor->name);
+    }
+
+    const gen_size_t shards =
+            descriptor->kind == GEN_METRICS_KIND_GAUGE ? 1 : GEN_METRICS_SHARDS;
+    const gen_size_t length =
+            descriptor->kind == GEN_METRICS_KIND_HISTOGRAM ?
+            GEN_METRICS_HISTOGRAM_VALUES : 1;
+
+    if(descriptor->offset + length > GEN_METRICS_SHARD_VALUES) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_BAD_CONTENT, GEN_LINE_STRING,
+                "Metric `%t` lies outside of the region", descriptor->name);
+    }
+
+    gen_uint64_t values[GEN_METRICS_HISTOGRAM_VALUES] = {0};
+    for(gen_size_t i = 0; i < shards; ++i) {
+        const gen_uint64_t* const shard =
+                &region->shards[i][descriptor->offset];
+
+        for(gen_size_t j = 0; j < length; ++j) {
+            values[j] += __atomic_load_n(&shard[j], __ATOMIC_RELAXED);
+        }
+    }
+
+    const char* const kinds[] = {
+        [GEN_METRICS_KIND_COUNTER] = "counter",
+        [GEN_METRICS_KIND_GAUGE] = "gauge",
+        [GEN_METRICS_KIND_HISTOGRAM] = "histogram"
+    };
+
+    // Names are padded with zeroes but may still fill the whole field.
+    char name[GEN_METRICS_NAME_LENGTH + 1] = {0};
+    for(gen_size_t i = 0; i < GEN_METRICS_NAME_LENGTH; ++i) {
+        name[i] = descriptor->name[i];
+    }
+
+    char line[GEN_METRICS_NAME_LENGTH + 128] = {0};
+    gen_size_t line_length = 0;
+    if(descriptor->kind == GEN_METRICS_KIND_HISTOGRAM) {
+        const gen_uint64_t* const buckets = &values[2];
+
+        error = gen_format(
+                line, &line_length, sizeof(line) - 1,
+                "%t\t%t\t%ul\t%ul\t%ul\t%ul\n", name, kinds[descriptor->kind],
+                values[0], values[1],
+                gen_metrics_reader_internal_quantile(buckets, values[0], 50),
+                gen_metrics_reader_internal_quantile(buckets, values[0], 99));
+        if(error) return error;
+    }
+    else {
+        error = gen_format(
+                line, &line_length, sizeof(line) - 1, "%t\t%t\t%ul\n", name,
+                kinds[descriptor->kind], values[0]);
+        if(error) return error;
+    }
+
+    return gen_stream_writer_write(
+            writer, line, GEN_MINIMUM(line_length, sizeof(line) - 1));
+}
+
+// Prints a snapshot of every metric in the region as tab-separated fields:
+// name, kind and value, or for histograms name, kind, count, sum and the
+// upper bounds of the buckets holding the median and 99th percentile.
+static gen_error_t* gen_metrics_reader_internal_main(
+        const gen_size_t argc, const char* const* const argv) {
+
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    if(argc != 2) {
+        return gen_error_attach_backtrace(
+                GEN_ERROR_INVALID_PARAMETER, GEN_LINE_STRING,
+                "Usage: genmetricsreader <path>");
+    }
+
+    gen_file_t file = {0};
+    error = gen_file_open(argv[1], GEN_FILE_ACCESS_READ, &file);
+    if(error) return error;
+
+    gen_file_mapping_t mapping = {0};
+    error = gen_file_map(&file, GEN_FILE_ACCESS_READ, &mapping);
+    if(error) return error;
+
+    const gen_metrics_region_t* const region = mapping.data;
+    if(mapping.size < sizeof(*region) ||
+       region->magic != GEN_METRICS_MAGIC) {
+
+        return gen_error_attach_backtrace(
+                GEN_ERROR_WRONG_OBJECT_TYPE, GEN_LINE_STRING,
+                "`%t` is not a metrics region", argv[1]);
+    }
+
+    gen_system_allocator_t allocator = {0};
+    error = gen_get_system_allocator(&allocator);
+    if(error) return error;
+
+    gen_file_t output_file = {0};
+    error = gen_file_get_standard(GEN_FILE_STANDARD_OUTPUT, &output_file);
+    if(error) return error;
+
+    gen_stream_writer_t writer = {0};
+    error = gen_stream_writer_create(&allocator, &output_file, 0, &writer);
+    if(error) return error;
+
+    const gen_size_t count = GEN_MINIMUM(
+            __atomic_load_n(&region->count, __ATOMIC_ACQUIRE),
+            GEN_METRICS_MAXIMUM);
+
+    for(gen_size_t i = 0; i < count; ++i) {
+        error = gen_metrics_reader_internal_write_metric(
+                &writer, region, &region->descriptors[i]);
+        if(error) return error;
+    }
+
+    error = gen_stream_writer_destroy(&writer);
+    if(error) return error;
+
+    error = gen_file_unmap(&mapping);
+    if(error) return error;
+
+    return gen_file_close(&file);
+}
+
+int main(int argc, char** argv) {
+    gen_tooling_push(GEN_FUNCTION_NAME, GEN_FILE_NAME);
+    GEN_TOOLING_AUTO gen_error_t* error;
+
+    error = gen_metrics_reader_internal_main(
+            (gen_size_t) argc, (const char* const*) argv);
+    if(error) {
+        gen_log(GEN_LOG_LEVEL_FATAL, "genmetricsreader", "%e", error);
+        gen_abort();
+    }
+}